@@ -4,6 +4,12 @@
 
 const float TILE_SIZEf = 50.f;
 const int TILE_SIZEi = 50;
+const int CHUNK_SIZEi = 16;	// tiles per chunk side, see Scene/TileChunk.hpp
+const int STREAMING_RADIUS = 2;	// chunks kept around the camera when streaming a level
+const int ENTITY_POOL_SIZE = 4096;	// entities the World holds without allocating
+const float SIMULATION_RATE = 60.f;	// simulation steps per second, independent of the frame rate
+const float SIMULATION_STEP = 1.f / SIMULATION_RATE;	// dt of every step, in every runner: replays depend on it
+const int MAX_SIMULATION_STEPS = 5;	// per frame: time beyond that is dropped rather than caught up
 const float SCREEN_WIDTH = TILE_SIZEi * 16;
 const float SCREEN_HEIGHT = TILE_SIZEi * 9;
 const std::string BASE_PATH = "";
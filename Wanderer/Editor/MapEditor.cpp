@@ -1,5 +1,6 @@
 #include "MapEditor.hpp"
 #include "Constants.hpp"
+#include "Scene/RenderStats.hpp"
 #include <imgui-SFML.h>
 #include <imgui.h>
 #include <iomanip>
@@ -83,17 +84,24 @@ void MapEditor::render()
 	if (Button("Save level"))
 		saveLevel(LEVELS_PATH + m_levelFilenameBuffer);
 	SameLine();
-	if (Button("Load level"))
+	if (Button("Load level") && !isLocked())
 		m_gs.loadLevel(LEVELS_PATH + (const std::string)m_levelFilenameBuffer);
+	if (Button("Export text"))
+		exportLevelText(LEVELS_PATH + m_levelFilenameBuffer);
+	SameLine();
+	if (Button("Import text") && !isLocked())
+		m_gs.loadLevel(LEVELS_PATH + (const std::string)m_levelFilenameBuffer, true);
+	if (isLocked())
+		Text("Editing disabled while recording or replaying");
 
 
 	Text("Tiles window");
 	int imguiIds = 0;
-	for (TileId i = 0; i < m_tilesSprites.size(); ++i) {
+	for (size_t i = 0; i < m_tilesSprites.size(); ++i) {
 		PushID(imguiIds++);
 		if (ImageButton(m_tilesSprites[i])) {
 			m_selectingTile = true;
-			m_selectedTile = i;
+			m_selectedTile = (TileId)i;
 			updateHover();
 		}
 		PopID();
@@ -115,6 +123,19 @@ void MapEditor::render()
 			SameLine(0.f, 0.f);
 	}
 
+	Text("Tile tool");
+	int tool = (int)m_tool;
+	RadioButton("Brush", &tool, (int)Tool::Brush);
+	SameLine();
+	RadioButton("Rectangle", &tool, (int)Tool::Rectangle);
+	SameLine();
+	RadioButton("Fill", &tool, (int)Tool::Fill);
+	if (tool != (int)m_tool)
+	{
+		endStroke();
+		m_tool = (Tool)tool;
+	}
+
 	Checkbox("Cam on player", &(m_gs.m_cameraOnPlayer));
 
 	End();	// Map editor
@@ -152,7 +173,20 @@ void MapEditor::renderHover()
 			});
 		}
 
-		w.draw(m_hover);
+		RenderStats::draw(w, m_hover, sf::RenderStates::Default);
+	}
+
+	// Rectangle being dragged
+	if (m_stroking && m_tool == Tool::Rectangle)
+	{
+		const sf::Vector2i topLeft(std::min(m_strokeStart.x, m_lastStrokeTile.x), std::min(m_strokeStart.y, m_lastStrokeTile.y));
+		const sf::Vector2i size(std::abs(m_strokeStart.x - m_lastStrokeTile.x) + 1, std::abs(m_strokeStart.y - m_lastStrokeTile.y) + 1);
+		m_rectPreview.setPosition(sf::Vector2f(topLeft) * TILE_SIZEf);
+		m_rectPreview.setSize(sf::Vector2f(size) * TILE_SIZEf);
+		m_rectPreview.setFillColor(sf::Color(255, 255, 255, 48));
+		m_rectPreview.setOutlineColor(m_strokeMouseCode == 0 ? sf::Color::Red : sf::Color::White);
+		m_rectPreview.setOutlineThickness(1.f);
+		RenderStats::draw(w, m_rectPreview, sf::RenderStates::Default);
 	}
 }
 void MapEditor::handleInputs()
@@ -172,6 +206,14 @@ void MapEditor::handleInputs()
 		return;
 	}
 
+	// No edit in a recorded or replayed session, a pending rectangle is dropped
+	if (isLocked())
+	{
+		m_stroking = false;
+		// BREAKING THE FUNCTION!
+		return;
+	}
+
 	// mouse management
 	char mouseCode = -1;	// unhandled value
 	if (sf::Mouse::isButtonPressed(sf::Mouse::Left))
@@ -180,15 +222,13 @@ void MapEditor::handleInputs()
 		mouseCode = 1;
 	else
 	{
+		endStroke();	// button released: rectangles are applied now
 		// BREAKING THE FUNCTION!
 		return;
 	}
 
-	if (m_selectingTile && m_editTileTimer.getElapsedTime() > m_editTileDelay)
-	{
-		placeOrRemoveTile(mouseCode);
-		m_editTileTimer.restart();
-	}
+	if (m_selectingTile)
+		updateStroke(mouseCode);
 	else if (!m_selectingTile && m_editEntityTimer.getElapsedTime() > m_editEntityDelay)
 	{
 		placeOrRemoveEntity(mouseCode);
@@ -210,28 +250,42 @@ void MapEditor::handleMapWindowEvent(const sf::Event& event)
 			(int)std::floor(worldCoords.y / TILE_SIZEi)
 		};
 
-		updateSelectedTile(m_gs.m_map.getTile(mouseTileCoords.x, mouseTileCoords.y));
+		updateSelectedTile(m_gs.m_simulation.getMap().getTile(mouseTileCoords.x, mouseTileCoords.y));
 	}
 }
 
 void MapEditor::saveLevel(const std::string& levelFilename) const
 {
-	// Saving map
-	std::ofstream mapSaveStream(levelFilename + "/map.txt");
-	if (mapSaveStream)
+	// The tiles registry is the palette: map cells are TileIds
+	std::string palette;
+	for (const Tile& tile : m_tilesMgr.getTiles())
+		palette += tile.indexInFile;
+
+	// Positions are saved as is: the map origin is stable
+	std::vector<LevelEntity> entities;
+	const World& world = m_gs.m_simulation.getWorld();
+	entities.push_back({ LevelEntity::Type::Player, world.positions[m_gs.getPlayer()].x, world.positions[m_gs.getPlayer()].y });
+	for (std::size_t i = 0; i < world.size(); ++i)
 	{
-		for (int y = 0; y < m_gs.m_map.GRID_HEIGHT; ++y)
-		{
-			for (int x = 0; x < m_gs.m_map.GRID_WIDTH; ++x)
-				mapSaveStream << m_gs.m_map.getTileIndex(x, y) << " ";
-
-			if (y + 1 < m_gs.m_map.GRID_HEIGHT)
-				mapSaveStream << '\n';
-		}
+		if (world.kinds[i] == EntityKind::Enemy)
+			entities.push_back({ LevelEntity::Type::Enemy, world.positions[i].x, world.positions[i].y });
 	}
-	else
-		std::cerr << "couldn't create map save file stream!" << std::endl;
 
+	// Every chunk is needed, and the file being written may be the one mapped for streaming
+	m_gs.m_simulation.getMap().stopStreaming();
+	if (!LevelFile::write(levelFilename + "/level.bin", CHUNK_SIZEi, palette, m_gs.m_simulation.getMap().exportChunks(), entities))
+		std::cerr << "couldn't save level " << levelFilename << "!" << std::endl;
+}
+
+void MapEditor::exportLevelText(const std::string& levelFilename) const
+{
+	// Saving map: the file starts at the top-left of the map bounds
+	m_gs.m_simulation.getMap().stopStreaming();
+	const sf::IntRect bounds = m_gs.m_simulation.getMap().getBounds();
+	m_gs.m_simulation.getMap().save(levelFilename + "/map.txt");
+
+	// Entities are saved relative to the file origin
+	const sf::Vector2f origin(static_cast<float>(bounds.left) * TILE_SIZEf, static_cast<float>(bounds.top) * TILE_SIZEf);
 
 	// Saving entities
 	std::ofstream entitiesSaveStream(levelFilename + "/entities.json");
@@ -239,13 +293,17 @@ void MapEditor::saveLevel(const std::string& levelFilename) const
 	{
 		nlohmann::json data;
 
-		const auto& player = *(m_gs.m_player);
-		data["player"] = { player.getPosition().x, player.getPosition().y };
+		const World& world = m_gs.m_simulation.getWorld();
+		const sf::Vector2f& player = world.positions[m_gs.getPlayer()];
+		data["player"] = { player.x - origin.x, player.y - origin.y };
 
 		data["enemies"] = {};
-		for (const Enemy* enemy : m_gs.m_enemies)
+		for (std::size_t i = 0; i < world.size(); ++i)
 		{
-			std::vector<float> vec_pos = { enemy->getPosition().x, enemy->getPosition().y };
+			if (world.kinds[i] != EntityKind::Enemy)
+				continue;
+
+			std::vector<float> vec_pos = { world.positions[i].x - origin.x, world.positions[i].y - origin.y };
 			data["enemies"].emplace_back(std::move(vec_pos));
 		}
 
@@ -255,45 +313,106 @@ void MapEditor::saveLevel(const std::string& levelFilename) const
 		std::cerr << "couldn't create entities save file stream!" << std::endl;
 }
 
-void MapEditor::placeOrRemoveTile(int mouseCode)
+sf::Vector2i MapEditor::getMouseTileCoords() const
 {
 	sf::Vector2f worldCoords = m_gs.m_window->mapPixelToCoords(
 	sf::Mouse::getPosition(*m_gs.m_window), m_gs.m_window->getView());
 
-	sf::Vector2i mouseTileCoords{
+	return {
 		(int)std::floor(worldCoords.x / TILE_SIZEi),
 		(int)std::floor(worldCoords.y / TILE_SIZEi)
 	};
+}
 
-	// To compare previous and after states
-	sf::Vector2i previousGridSize{
-		m_gs.m_map.GRID_WIDTH,
-		m_gs.m_map.GRID_HEIGHT,
-	};
-
-	// Hint to know how to translate entities and view
-	bool newColLeft = false;
-	bool newRowTop = false;
-
-	TileId newTile = (mouseCode == 0)
+TileId MapEditor::getPaintedTile(int mouseCode) const
+{
+	return (mouseCode == 0)
 		? m_tilesMgr.getDefaultTile()
 		: m_selectedTile;
-	m_gs.m_map.setTile(mouseTileCoords.x, mouseTileCoords.y, newTile, &newColLeft, &newRowTop);
+}
+
+bool MapEditor::isLocked() const
+{
+	return m_gs.m_recording || m_gs.m_replayPlayer;
+}
 
-	// Translate entities and view if needed
-	sf::Vector2f translation;
-	if (newColLeft)	translation.x = static_cast<float>(m_gs.m_map.GRID_WIDTH  - previousGridSize.x) * TILE_SIZEi;
-	if (newRowTop)	translation.y = static_cast<float>(m_gs.m_map.GRID_HEIGHT - previousGridSize.y) * TILE_SIZEi;
+void MapEditor::updateStroke(int mouseCode)
+{
+	const sf::Vector2i tile = getMouseTileCoords();
 
-	if (translation != sf::Vector2f())
+	if (!m_stroking)	// button just pressed
 	{
-		std::cout << "translating" << std::endl;
+		m_stroking = true;
+		m_strokeMouseCode = mouseCode;
+		m_strokeStart = tile;
+		m_lastStrokeTile = tile;
+
+		if (m_tool == Tool::Brush)
+			paintLine(tile, tile, getPaintedTile(mouseCode));
+		else if (m_tool == Tool::Fill)
+			m_gs.m_simulation.getMap().floodFill(tile, getPaintedTile(mouseCode));
+		return;
+	}
 
-		for (GameObject* entity : m_gs.m_entities)
-			entity->move(translation);
+	// The mouse may have crossed several tiles since last frame: no gap in the stroke
+	if (m_tool == Tool::Brush && tile != m_lastStrokeTile)
+		paintLine(m_lastStrokeTile, tile, getPaintedTile(m_strokeMouseCode));
+	m_lastStrokeTile = tile;
+}
+
+void MapEditor::endStroke()
+{
+	if (!m_stroking)
+		return;
 
-		m_gs.moveCamera(translation);
+	m_stroking = false;
+	if (m_tool == Tool::Rectangle)
+		paintRect(m_strokeStart, m_lastStrokeTile, getPaintedTile(m_strokeMouseCode));
+}
+
+void MapEditor::paintLine(const sf::Vector2i& from, const sf::Vector2i& to, TileId tile)
+{
+	// Bresenham: every tile the segment goes through
+	const int dx = std::abs(to.x - from.x);
+	const int dy = -std::abs(to.y - from.y);
+	const int stepX = from.x < to.x ? 1 : -1;
+	const int stepY = from.y < to.y ? 1 : -1;
+	int error = dx + dy;
+	sf::Vector2i p = from;
+
+	Map& map = m_gs.m_simulation.getMap();
+	map.beginEdit();
+	for (;;)
+	{
+		map.setTile(p.x, p.y, tile);
+		if (p == to)
+			break;
+
+		const int doubledError = 2 * error;
+		if (doubledError >= dy)
+		{
+			error += dy;
+			p.x += stepX;
+		}
+		if (doubledError <= dx)
+		{
+			error += dx;
+			p.y += stepY;
+		}
+	}
+	map.endEdit();
+}
+
+void MapEditor::paintRect(const sf::Vector2i& corner1, const sf::Vector2i& corner2, TileId tile)
+{
+	Map& map = m_gs.m_simulation.getMap();
+	map.beginEdit();
+	for (int y = std::min(corner1.y, corner2.y); y <= std::max(corner1.y, corner2.y); ++y)
+	{
+		for (int x = std::min(corner1.x, corner2.x); x <= std::max(corner1.x, corner2.x); ++x)
+			map.setTile(x, y, tile);
 	}
+	map.endEdit();
 }
 
 void MapEditor::placeOrRemoveEntity(int mouseCode)
@@ -309,62 +428,31 @@ void MapEditor::placeOrRemoveEntity(int mouseCode)
 	if (entityType == "player")
 	{
 		// Whatever the mouse code, we tp the player to mouse
-		m_gs.m_player->setPosition(worldCoords - bias);
+		m_gs.m_simulation.getWorld().setPosition(m_gs.getPlayer(), worldCoords - bias);
 	}
 	else if (entityType == "enemy")
 	{
 		if (mouseCode == 0)
 		{
-			GameObject* gameObjPtr = nullptr;
-			// Delete Enemy* ptr
-			for (auto it = m_gs.m_enemies.begin(); it != m_gs.m_enemies.end(); ++it)
-			{
-				const auto& box = (*it)->getHitbox();
-				if (boxContains(box, worldCoords))
-				{
-					gameObjPtr = *it;
-					std::cout << "Found entity to destroy (" << gameObjPtr << ')' << std::endl;
-					m_gs.m_enemies.erase(it);
-//					std::cout << "nb enemies: " << m_gs.m_enemies.size() << std::endl;
-					break;
-				}
-			}
-
-			if (!gameObjPtr)
-			{
-				std::cerr << "Didn't find any enemy to destroy at cursor position!" << std::endl;
-				// BREAKING THE FUNCTION!
-				return;
-			}
-
-			// Delete GameObject* ptr
-			for (auto it = m_gs.m_entities.begin(); it != m_gs.m_entities.end(); ++it)
+			const World& world = m_gs.m_simulation.getWorld();
+			std::vector<std::size_t> picked;
+			world.pick(worldCoords, picked);
+			for (std::size_t entity : picked)
 			{
-				if (*it == gameObjPtr)
+				if (world.kinds[entity] == EntityKind::Enemy)
 				{
-					m_gs.m_entities.erase(it);
-//					std::cout << "nb entities: " << m_gs.m_entities.size() << std::endl;
-					break;
+					m_gs.m_simulation.despawnEntity(world.handleOf(entity));
+					// BREAKING THE FUNCTION!
+					return;
 				}
 			}
 
-			// Delete Drawable* in the mob layer
-			const sf::Drawable* drawablePtr = gameObjPtr;
-//			std::cout << "The drawable-version ptr: " << drawablePtr << std::endl;
-			m_gs.m_layers["mobsLayer"].removeObject(drawablePtr);
-
-			delete gameObjPtr;
-			// EXITING THE FUNCTION...
+			std::cerr << "Didn't find any enemy to destroy at cursor position!" << std::endl;
 		}
 		else if (mouseCode == 1)
 		{
-			auto* enemy = new Enemy();
-			m_gs.m_enemies.push_back(enemy);
-			m_gs.m_entities.push_back(enemy);
-
-			enemy->setPosition(worldCoords - bias);
-			enemy->setTexture(m_gs.m_tileset);
-			m_gs.m_layers["mobsLayer"].addObject(enemy);
+			const sf::Vector2f position = worldCoords - bias;
+			m_gs.m_simulation.spawnEntity(LevelEntity::Type::Enemy, position.x, position.y);
 		}
 	}
 }
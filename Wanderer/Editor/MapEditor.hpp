@@ -1,7 +1,6 @@
 #pragma once
 
 #include "Scene/Map.hpp"
-#include "Entity/GameObject.hpp"
 #include "Constants.hpp"
 #include "Scene/GameScene.hpp"
 #include "Scene/Tile.hpp"
@@ -27,14 +26,24 @@ public:
 
 	void handleInputs();
 	void handleMapWindowEvent(const sf::Event& event);
-	void saveLevel(const std::string& levelFilename) const;
-	void placeOrRemoveTile(int mouseCode);
+	void saveLevel(const std::string& levelFilename) const;			// binary level.bin
+	void exportLevelText(const std::string& levelFilename) const;	// map.txt + entities.json
 	void placeOrRemoveEntity(int mouseCode);
 
+	// Tile tools: each edit is a single map transaction
+	void paintLine(const sf::Vector2i& from, const sf::Vector2i& to, TileId tile);	// brush stroke between two mouse samples
+	void paintRect(const sf::Vector2i& corner1, const sf::Vector2i& corner2, TileId tile);	// the fill tool is Map::floodFill()
+
 	void updateSelectedTile(TileId id);
 	void updateHover();
 
 private:
+	[[nodiscard]] sf::Vector2i getMouseTileCoords() const;
+	[[nodiscard]] TileId getPaintedTile(int mouseCode) const;	// left button erases, right button places
+	[[nodiscard]] bool isLocked() const;	// a session is recorded or played back: edits would not be in the replay
+	void updateStroke(int mouseCode);
+	void endStroke();
+
 	GameScene& m_gs;
 	TilesManager& m_tilesMgr;
 
@@ -54,8 +63,15 @@ private:
 	char m_levelFilenameBuffer[64] = "";
 	sf::Sprite m_hover;
 
-	sf::Time m_editTileDelay = sf::milliseconds(10);
-	sf::Clock m_editTileTimer;	// prevent from spamming
+	// Tile tools
+	enum class Tool { Brush, Rectangle, Fill };
+	Tool m_tool = Tool::Brush;
+	bool m_stroking = false;	// a mouse button is held since the stroke began
+	int m_strokeMouseCode = 0;
+	sf::Vector2i m_strokeStart;		// tile where the stroke began, rectangle corner
+	sf::Vector2i m_lastStrokeTile;	// tile under the mouse at the previous frame
+	sf::RectangleShape m_rectPreview;
+
 	sf::Time m_editEntityDelay = sf::milliseconds(1000);
 	sf::Clock m_editEntityTimer;	// prevent from spamming
 };
@@ -0,0 +1,123 @@
+#include "Entity/AnimationLibrary.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+std::shared_ptr<const AnimationSet> AnimationLibrary::load(const std::string& filename)
+{
+	auto& cache = getCache();
+	auto it = cache.find(filename);
+	if (it != cache.end())
+		return it->second;
+
+	auto set = std::make_shared<AnimationSet>();
+	if (!parse(filename, *set))
+		return nullptr;
+
+	cache.emplace(filename, set);
+	return set;
+}
+
+void AnimationLibrary::clear()
+{
+	getCache().clear();
+}
+
+std::unordered_map<std::string, std::shared_ptr<const AnimationSet>>& AnimationLibrary::getCache()
+{
+	static std::unordered_map<std::string, std::shared_ptr<const AnimationSet>> cache;
+	return cache;
+}
+
+bool AnimationLibrary::parse(const std::string& filename, AnimationSet& set)
+{
+	using namespace std;
+	ifstream animationFile(filename);
+
+	if (!animationFile)
+	{
+		cerr << "failed to create animation file stream: " << filename << endl;
+		return false;
+	}
+
+	std::map<string, Animation> animations;	// by name while parsing, a clip may be declared twice
+	string currentAnimationName;
+
+	string prefixes[6] = {
+		"#",
+		"-",
+		"frameCount: ",
+		"durations: ",
+		"subTextureCoords: ",
+		"hitboxCoords: "
+	};
+
+	string line;
+	while (getline(animationFile, line))
+	{
+		if (line.empty())	// empty line
+			continue;
+		else if (line.compare(0, prefixes[0].size(), prefixes[0]) == 0)	// comment line
+			continue;
+		else if (line.compare(0, prefixes[1].size(), prefixes[1]) == 0)	// animation name
+		{
+			currentAnimationName = line.substr(prefixes[1].size());
+			animations[currentAnimationName].m_name = currentAnimationName;
+		}
+		else if (line.compare(0, prefixes[2].size(), prefixes[2]) == 0)	// frame count
+		{
+			istringstream lineStream(line.substr(prefixes[2].size()));
+			size_t n = 0;
+			lineStream >> n;
+			animations[currentAnimationName].m_frameCount = n;
+		}
+		else if (line.compare(0, prefixes[3].size(), prefixes[3]) == 0)	// durations
+		{
+			istringstream lineStream(line.substr(prefixes[3].size()));
+			float f;
+			while (lineStream >> f)	// must be called m_frameCount times
+				animations[currentAnimationName].m_frameDurations.push_back(f);
+		}
+		else if (line.compare(0, prefixes[4].size(), prefixes[4]) == 0)	// subTextures coords
+		{
+			istringstream lineStream(line.substr(prefixes[4].size()));
+			int x, y, w, h;
+			while (lineStream >> x >> y >> w >> h)	// must be called m_frameCount times
+				animations[currentAnimationName].m_subTextureCoords.emplace_back(x, y, w, h);
+		}
+		else if (line.compare(0, prefixes[5].size(), prefixes[5]) == 0)	// hitboxes coords
+		{
+			istringstream lineStream(line.substr(prefixes[5].size()));
+			float x, y, w, h;
+			while (lineStream >> x >> y >> w >> h)	// must be called m_frameCount times
+				animations[currentAnimationName].m_hitboxCoords.push_back({ x, y, w, h });
+		}
+	}
+
+	// Playback indexes every array with the frame index: incomplete clips are dropped
+	for (auto it = animations.begin(); it != animations.end();)
+	{
+		const Animation& animation = it->second;
+		if (animation.m_frameCount == 0 ||
+			animation.m_frameDurations.size() != animation.m_frameCount ||
+			animation.m_subTextureCoords.size() != animation.m_frameCount ||
+			animation.m_hitboxCoords.size() != animation.m_frameCount)
+		{
+			cerr << filename << ": animation " << it->first << " doesn't have " << animation.m_frameCount << " complete frames, skipped" << endl;
+			it = animations.erase(it);
+		}
+		else
+			++it;
+	}
+
+	// Dense ids
+	for (auto& [name, animation] : animations)
+	{
+		set.ids.emplace(name, (AnimationId)set.animations.size());
+		set.animations.push_back(std::move(animation));
+	}
+
+	return true;
+}
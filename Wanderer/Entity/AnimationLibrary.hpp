@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Entity/Animation.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef std::int16_t AnimationId;	// index of a clip in its AnimationSet
+constexpr AnimationId NO_ANIMATION = -1;
+
+/** Every clip of an animation file. Clips are resolved by name once, then played by id **/
+struct AnimationSet
+{
+	std::vector<Animation> animations;	// indexed by AnimationId
+	std::unordered_map<std::string, AnimationId> ids;
+
+	[[nodiscard]] AnimationId find(const std::string& name) const
+	{
+		auto it = ids.find(name);
+		return it != ids.end() ? it->second : NO_ANIMATION;
+	}
+};
+
+/** Parses each animation file once: later loads of the same file share the same immutable set,
+ *  spawning an entity only copies a pointer **/
+class AnimationLibrary
+{
+public:
+	// nullptr if the file can't be read
+	static std::shared_ptr<const AnimationSet> load(const std::string& filename);
+
+	// Forget every cached set, sets still held by entities stay alive
+	static void clear();
+
+private:
+	static bool parse(const std::string& filename, AnimationSet& set);
+	static std::unordered_map<std::string, std::shared_ptr<const AnimationSet>>& getCache();
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Entity/AnimationLibrary.hpp"
+#include "Entity/Direction.hpp"
+#include "Entity/WalkingState.hpp"
+#include "Entity/YState.hpp"
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+
+/** Plain data components, stored in one contiguous array each by the World **/
+
+enum class EntityKind : std::uint8_t
+{
+	Player,
+	Enemy
+};
+
+// Walking/jumping/climbing state machine, advanced by World::updateKinematics()
+struct Kinematics
+{
+	sf::Vector2f velocity;
+	sf::Vector2f movement;	// wanted for this frame, applied against the map by GameScene
+
+	Direction facing = Direction::Right;
+	WalkingState walkingState = WalkingState::Idle;
+	float timeWalkingState = 0.f;
+	float maxVelocityX = 400.f;	// per entity to change max speed
+
+	YState yState = YState::Falling;
+	float timeFalling = 0.f;
+	float timeJumping = 0.f;
+	Direction climbingDirection = Direction::None;
+};
+
+struct Health
+{
+	unsigned int hp = 100;
+	unsigned int maxHp = 100;
+	bool invincible = false;
+	float invincibilityTime = 0.f;
+	float invincibilityMaxTime = 0.f;
+};
+
+// Clips played by World::updateAnimations(), resolved once at spawn
+struct AnimationClips
+{
+	AnimationId climbing = NO_ANIMATION;
+	AnimationId idleRight = NO_ANIMATION;
+	AnimationId right = NO_ANIMATION;
+	AnimationId idleLeft = NO_ANIMATION;
+	AnimationId left = NO_ANIMATION;
+};
+
+// Playback state only: frames are shared in the AnimationSet
+struct AnimationState
+{
+	const AnimationSet* set = nullptr;	// kept alive by the World
+	AnimationClips clips;
+	AnimationId current = NO_ANIMATION;
+	std::uint16_t frame = 0;
+	float elapsedTime = 0.f;
+	sf::IntRect textureRect;	// current frame, also gives the hitbox size
+};
@@ -1,24 +0,0 @@
-#include "Enemy.hpp"
-#include "Constants.hpp"
-
-Enemy::Enemy()
-{
-	AnimatedGameObject::loadFromFile(ANIMATIONS_PATH + "enemy.txt");
-	AnimatedGameObject::setCurrentAnimationName("right");
-	setWalkingState(WalkingState::Beginning);
-
-	MovingCharacter::m_maxVelocityX = 200.0f;
-}
-
-Enemy::~Enemy()
-{
-
-}
-
-void Enemy::toggleFacing()
-{
-	if (m_facing == Direction::Right)
-		m_facing = Direction::Left;
-	else if (m_facing == Direction::Left)
-		m_facing = Direction::Right;
-}
\ No newline at end of file
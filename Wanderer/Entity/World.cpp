@@ -0,0 +1,488 @@
+#include "Entity/World.hpp"
+#include "Constants.hpp"
+#include "Utility/Logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+	// Walking
+	const float MAX_TIME_WALKING_BEGINNING = 0.3f;
+	const float MAX_TIME_WALKING_END = 0.3f;
+
+	// Jumping and falling
+	const float MAX_TIME_JUMPING = 0.3f;
+	const float MAX_VELOCITY_Y_JUMPING = 1300.f;
+	const float ALPHA_JUMPING = MAX_VELOCITY_Y_JUMPING / MAX_TIME_JUMPING;
+	const float ALPHA_FALLING = ALPHA_JUMPING;
+
+	const float CLIMBING_VELOCITY = 200.f;
+}
+
+World::World()
+	: m_broadphase(2.f * TILE_SIZEf)	// a few entities per cell
+{
+	reserve((std::size_t)ENTITY_POOL_SIZE);
+}
+
+void World::reserve(std::size_t capacity)
+{
+	kinds.reserve(capacity);
+	active.reserve(capacity);
+	positions.reserve(capacity);
+	previousPositions.reserve(capacity);
+	hitboxes.reserve(capacity);
+	kinematics.reserve(capacity);
+	healths.reserve(capacity);
+	animations.reserve(capacity);
+	m_slotToIndex.reserve(capacity);
+	m_generations.reserve(capacity);
+	m_freeSlots.reserve(capacity);
+	m_indexToSlot.reserve(capacity);
+}
+
+EntityHandle World::spawn(EntityKind kind, const sf::Vector2f& position, const std::shared_ptr<const AnimationSet>& animationSet, float maxVelocityX)
+{
+	const std::size_t entity = kinds.size();
+	if (entity == kinds.capacity())
+		std::cerr << "World: more than " << entity << " entities, the pool grows" << std::endl;
+
+	// Slot: a freed one if any
+	std::uint32_t slot;
+	if (!m_freeSlots.empty())
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		slot = (std::uint32_t)m_slotToIndex.size();
+		m_slotToIndex.push_back(0);
+		m_generations.push_back(0);
+	}
+	m_slotToIndex[slot] = (std::uint32_t)entity;
+	m_indexToSlot.push_back(slot);
+
+	kinds.push_back(kind);
+	active.push_back(1);
+	positions.push_back(position);
+	previousPositions.push_back(position);
+	hitboxes.push_back({ position.x, position.y, 0.f, 0.f });
+	kinematics.emplace_back();
+	kinematics.back().maxVelocityX = maxVelocityX;
+	healths.emplace_back();
+	animations.emplace_back();
+
+	// Clips are parsed once per file and resolved once per set
+	if (animationSet)
+	{
+		auto it = std::find_if(m_animationSets.begin(), m_animationSets.end(),
+			[&](const SharedAnimationSet& shared) { return shared.set == animationSet; });
+		if (it == m_animationSets.end())
+		{
+			AnimationClips clips;
+			clips.climbing = animationSet->find("climbing");
+			clips.idleRight = animationSet->find("idleRight");
+			clips.right = animationSet->find("right");
+			clips.idleLeft = animationSet->find("idleLeft");
+			clips.left = animationSet->find("left");
+			m_animationSets.push_back({ animationSet, clips });
+			it = m_animationSets.end() - 1;
+		}
+
+		AnimationState& animation = animations.back();
+		animation.set = animationSet.get();
+		animation.clips = it->clips;
+		setAnimation(entity, animation.clips.right);
+	}
+
+	syncBroadphase(entity);
+	return { slot, m_generations[slot] };
+}
+
+bool World::despawn(EntityHandle handle)
+{
+	const std::size_t entity = indexOf(handle);
+	if (entity == NO_ENTITY)
+	{
+		std::cerr << "World: despawning a stale entity handle" << std::endl;
+		return false;
+	}
+
+	// The last entity fills the hole
+	const std::size_t last = kinds.size() - 1;
+	if (entity != last)
+	{
+		kinds[entity] = kinds[last];
+		active[entity] = active[last];
+		positions[entity] = positions[last];
+		previousPositions[entity] = previousPositions[last];
+		hitboxes[entity] = hitboxes[last];
+		kinematics[entity] = kinematics[last];
+		healths[entity] = healths[last];
+		animations[entity] = animations[last];
+		m_indexToSlot[entity] = m_indexToSlot[last];
+		m_slotToIndex[m_indexToSlot[entity]] = (std::uint32_t)entity;
+	}
+
+	kinds.pop_back();
+	active.pop_back();
+	positions.pop_back();
+	previousPositions.pop_back();
+	hitboxes.pop_back();
+	kinematics.pop_back();
+	healths.pop_back();
+	animations.pop_back();
+	m_indexToSlot.pop_back();
+
+	m_broadphase.remove(handle.slot);
+
+	// Outstanding handles to this slot become stale
+	++m_generations[handle.slot];
+	m_freeSlots.push_back(handle.slot);
+
+	return true;
+}
+
+void World::clear()
+{
+	for (std::uint32_t slot : m_indexToSlot)
+	{
+		++m_generations[slot];
+		m_freeSlots.push_back(slot);
+	}
+
+	kinds.clear();
+	active.clear();
+	positions.clear();
+	previousPositions.clear();
+	hitboxes.clear();
+	kinematics.clear();
+	healths.clear();
+	animations.clear();
+	m_indexToSlot.clear();
+	m_animationSets.clear();
+	m_broadphase.clear();
+}
+
+void World::save(Snapshot& snapshot) const
+{
+	snapshot.kinds = kinds;
+	snapshot.active = active;
+	snapshot.positions = positions;
+	snapshot.previousPositions = previousPositions;
+	snapshot.hitboxes = hitboxes;
+	snapshot.kinematics = kinematics;
+	snapshot.healths = healths;
+	snapshot.animations = animations;
+
+	snapshot.slotToIndex = m_slotToIndex;
+	snapshot.generations = m_generations;
+	snapshot.freeSlots = m_freeSlots;
+	snapshot.indexToSlot = m_indexToSlot;
+	snapshot.broadphase = m_broadphase;
+
+	snapshot.animationSets.clear();
+	for (const SharedAnimationSet& shared : m_animationSets)
+		snapshot.animationSets.emplace_back(shared.set, shared.clips);
+}
+
+void World::restore(const Snapshot& snapshot)
+{
+	kinds = snapshot.kinds;
+	active = snapshot.active;
+	positions = snapshot.positions;
+	previousPositions = snapshot.previousPositions;
+	hitboxes = snapshot.hitboxes;
+	kinematics = snapshot.kinematics;
+	healths = snapshot.healths;
+	animations = snapshot.animations;
+
+	m_slotToIndex = snapshot.slotToIndex;
+	m_generations = snapshot.generations;
+	m_freeSlots = snapshot.freeSlots;
+	m_indexToSlot = snapshot.indexToSlot;
+	m_broadphase = snapshot.broadphase;
+
+	m_animationSets.clear();
+	for (const auto& [set, clips] : snapshot.animationSets)
+		m_animationSets.push_back({ set, clips });
+}
+
+std::size_t World::indexOf(EntityHandle handle) const
+{
+	if (handle.slot >= m_generations.size() || m_generations[handle.slot] != handle.generation)
+		return NO_ENTITY;
+	return m_slotToIndex[handle.slot];
+}
+
+EntityHandle World::handleOf(std::size_t entity) const
+{
+	const std::uint32_t slot = m_indexToSlot[entity];
+	return { slot, m_generations[slot] };
+}
+
+void World::updateKinematics(float dt)
+{
+	for (std::size_t i = 0; i < kinematics.size(); ++i)
+	{
+		if (!active[i])
+			continue;
+
+		Kinematics& k = kinematics[i];
+
+		// YState update
+		if (k.yState == YState::Jumping && k.timeJumping >= MAX_TIME_JUMPING)
+			setYState(i, YState::Falling);
+
+		// WalkingState update
+		k.timeWalkingState += dt;
+		if (k.walkingState == WalkingState::Beginning && k.timeWalkingState >= MAX_TIME_WALKING_BEGINNING)
+			setWalkingState(i, WalkingState::Middle);
+		else if (k.walkingState == WalkingState::End && k.timeWalkingState >= MAX_TIME_WALKING_END)
+			setWalkingState(i, WalkingState::Idle);
+
+		// Calculate y movement
+		k.movement = sf::Vector2f();    // Reset
+
+		if (k.yState == YState::Falling)
+		{
+			k.timeFalling += dt;
+			k.velocity.y = ALPHA_FALLING * k.timeFalling;
+			k.movement.y = k.velocity.y * dt;
+		}
+		else if (k.yState == YState::Jumping)
+		{
+			k.timeJumping += dt;
+			k.velocity.y = -ALPHA_JUMPING * k.timeJumping + MAX_VELOCITY_Y_JUMPING;
+			k.movement.y = -k.velocity.y * dt;
+		}
+		else if (k.yState == YState::Climbing)
+		{
+			if (k.climbingDirection == Direction::Down)
+				k.movement.y = CLIMBING_VELOCITY * dt;
+			else if (k.climbingDirection == Direction::Up)
+				k.movement.y = -CLIMBING_VELOCITY * dt;
+			else
+				k.movement.y = 0.f;
+		}
+
+		// Calculate x movement
+		if (k.walkingState != WalkingState::Idle)
+		{
+			if (k.walkingState == WalkingState::Beginning)
+				k.velocity.x = k.maxVelocityX / MAX_TIME_WALKING_BEGINNING * k.timeWalkingState;
+			else if (k.walkingState == WalkingState::Middle)
+				k.velocity.x = k.maxVelocityX;
+			else	// walkingState == End
+				k.velocity.x = -k.maxVelocityX / MAX_TIME_WALKING_END * k.timeWalkingState + k.maxVelocityX;
+
+			if (k.facing == Direction::Left)
+				k.velocity.x *= -1;
+
+			k.movement.x = k.velocity.x * dt;
+		}
+		// Not rounded: whole pixels per step would make the speeds depend on SIMULATION_RATE
+	}
+}
+
+void World::updateHealth(float dt)
+{
+	for (std::size_t i = 0; i < healths.size(); ++i)
+	{
+		Health& health = healths[i];
+		if (!active[i] || !health.invincible)
+			continue;
+
+		health.invincibilityTime += dt;
+		if (health.invincibilityTime >= health.invincibilityMaxTime)
+			setInvincible(i, false);
+	}
+}
+
+void World::updateAnimations(float dt)
+{
+	for (std::size_t i = 0; i < animations.size(); ++i)
+	{
+		AnimationState& animation = animations[i];
+		if (!active[i] || !animation.set)
+			continue;
+
+		// Clip from the movement state
+		const Kinematics& k = kinematics[i];
+		if (k.yState == YState::Climbing)
+			setAnimation(i, animation.clips.climbing);
+		else if (k.facing == Direction::Right)
+			setAnimation(i, k.walkingState == WalkingState::Idle ? animation.clips.idleRight : animation.clips.right);
+		else
+			setAnimation(i, k.walkingState == WalkingState::Idle ? animation.clips.idleLeft : animation.clips.left);
+
+		if (animation.current == NO_ANIMATION)
+			continue;
+
+		// Frame
+		const Animation& clip = animation.set->animations[(std::size_t)animation.current];
+		animation.elapsedTime += dt;
+		if (animation.elapsedTime > clip.getFrameDuration(animation.frame))
+		{
+			// change animation frame (frameCount = 1 => index = 0, index < frameCount)
+			const std::uint16_t newFrame = (animation.frame + 1u < clip.getFrameCount()) ? (std::uint16_t)(animation.frame + 1) : (std::uint16_t)0;
+			animation.elapsedTime = 0.f;
+
+			if (newFrame != animation.frame)
+			{
+				animation.frame = newFrame;
+				animation.textureRect = clip.getSubTextureCoords(newFrame);
+				hitboxes[i].w = static_cast<float>(animation.textureRect.width);
+				hitboxes[i].h = static_cast<float>(animation.textureRect.height);
+				syncBroadphase(i);
+			}
+		}
+	}
+}
+
+void World::setAnimation(std::size_t entity, AnimationId id)
+{
+	AnimationState& animation = animations[entity];
+
+	// not already playing specified animation and existing clip
+	if (id == animation.current || id == NO_ANIMATION)
+		return;
+
+	// reset animation data from last play
+	animation.current = id;
+	animation.frame = 0;
+	animation.elapsedTime = 0.f;
+
+	// the hitbox is as large as the frame
+	animation.textureRect = animation.set->animations[(std::size_t)id].getSubTextureCoords(0);
+	hitboxes[entity].w = static_cast<float>(animation.textureRect.width);
+	hitboxes[entity].h = static_cast<float>(animation.textureRect.height);
+	syncBroadphase(entity);
+}
+
+void World::storePreviousPositions()
+{
+	previousPositions = positions;	// same size: no allocation
+}
+
+void World::setPosition(std::size_t entity, const sf::Vector2f& position)
+{
+	positions[entity] = position;
+	hitboxes[entity].x = position.x;
+	hitboxes[entity].y = position.y;
+	syncBroadphase(entity);
+}
+
+void World::query(const Box& region, std::vector<std::size_t>& entities) const
+{
+	m_querySlots.clear();
+	m_broadphase.query(region, m_querySlots);
+	for (std::uint32_t slot : m_querySlots)
+		entities.push_back(m_slotToIndex[slot]);
+}
+
+void World::pick(const sf::Vector2f& point, std::vector<std::size_t>& entities) const
+{
+	m_querySlots.clear();
+	m_broadphase.pick(point, m_querySlots);
+	for (std::uint32_t slot : m_querySlots)
+		entities.push_back(m_slotToIndex[slot]);
+}
+
+void World::findOverlappingPairs(std::vector<std::pair<std::size_t, std::size_t>>& pairs) const
+{
+	m_querySlotPairs.clear();
+	m_broadphase.findOverlappingPairs(m_querySlotPairs);
+	for (const auto& pair : m_querySlotPairs)
+		pairs.emplace_back(m_slotToIndex[pair.first], m_slotToIndex[pair.second]);
+}
+
+void World::setWalkingState(std::size_t entity, WalkingState walkingState)
+{
+	Kinematics& k = kinematics[entity];
+	if (walkingState == k.walkingState ||
+		(walkingState == WalkingState::Beginning && k.walkingState == WalkingState::Middle) ||
+		(walkingState == WalkingState::End && k.walkingState == WalkingState::Idle)
+		) return;
+
+	k.walkingState = walkingState;
+	k.timeWalkingState = 0.f;
+
+	if (k.walkingState == WalkingState::Idle)
+		k.velocity.x = 0.f;
+}
+
+void World::setYState(std::size_t entity, YState state)
+{
+	Kinematics& k = kinematics[entity];
+	if (state == k.yState)	// No change to perform
+		return;
+
+	// can't jump mid-air
+	if (state == YState::Jumping && (k.yState == YState::Jumping || k.yState == YState::Falling))
+		return;
+
+	k.yState = state;
+	k.velocity.y = 0.f;
+
+	if (k.yState == YState::Falling)
+		k.timeFalling = 0.f;
+	else if (k.yState == YState::Jumping)
+		k.timeJumping = 0.f;
+}
+
+void World::takeDamage(std::size_t entity, unsigned int amount)
+{
+	Health& health = healths[entity];
+	if (!health.invincible)
+		health.hp = (amount >= health.hp) ? 0 : health.hp - amount;
+}
+
+void World::setInvincible(std::size_t entity, bool invincible, float time)
+{
+	Health& health = healths[entity];
+	if (health.invincible == invincible || !isAlive(entity))
+		return;
+
+	health.invincible = invincible;
+
+	if (health.invincible)
+	{
+		health.invincibilityMaxTime = time;
+		health.invincibilityTime = 0.f;
+		LOG(Debug, "invicible");
+	}
+	else
+	{
+		LOG(Debug, "no more invicible");
+	}
+}
+
+void World::draw(sf::RenderTarget& target, sf::RenderStates states, EntityKind kind) const
+{
+	if (!m_texture)
+		return;
+
+	// Only entities intersecting the view are batched, all of them in a single draw call
+	const sf::View& view = target.getView();
+	const Box visible{ view.getCenter().x - view.getSize().x / 2.f, view.getCenter().y - view.getSize().y / 2.f,
+					   view.getSize().x, view.getSize().y };
+
+	m_batch.clear();
+	for (std::size_t i = 0; i < kinds.size(); ++i)
+	{
+		if (kinds[i] != kind)
+			continue;
+
+		// Between the last two simulation steps
+		const sf::Vector2f position = previousPositions[i] + (positions[i] - previousPositions[i]) * m_interpolation;
+		const sf::IntRect& rect = animations[i].textureRect;
+		const Box sprite{ position.x, position.y, (float)rect.width, (float)rect.height };
+		if (boxesOverlapping(sprite, visible))
+			m_batch.add(*m_texture, position, rect);
+	}
+	target.draw(m_batch, states);
+}
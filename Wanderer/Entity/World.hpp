@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Entity/Components.hpp"
+#include "Scene/SpriteBatch.hpp"
+#include "Utility/Box.hpp"
+#include "Utility/SpatialHash.hpp"
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/** Reference to an entity that outlives moves in the arrays. The generation changes when the slot is reused:
+ *  a handle to a despawned entity is detected, not silently redirected to another one **/
+struct EntityHandle
+{
+	static constexpr std::uint32_t NO_SLOT = (std::uint32_t)-1;
+
+	std::uint32_t slot = NO_SLOT;
+	std::uint32_t generation = 0;
+
+	bool operator==(const EntityHandle& other) const { return slot == other.slot && generation == other.generation; }
+	bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
+
+/** Every entity of a scene, stored as parallel component arrays: entity i is element i of each array.
+ *  Systems are plain loops over the arrays, no virtual call nor pointer chasing per entity **/
+class World
+{
+public:
+	static constexpr std::size_t NO_ENTITY = (std::size_t)-1;
+
+	World();
+	~World() = default;
+	World(const World&) = delete;
+	World& operator=(const World&) = delete;
+
+	void setTexture(const sf::Texture& texture) { m_texture = &texture; }
+
+	// Entity management, O(1) and allocation-free within the reserved capacity.
+	// Indexes are dense but not stable (despawn() moves the last entity into the hole): keep handles instead
+	EntityHandle spawn(EntityKind kind, const sf::Vector2f& position, const std::shared_ptr<const AnimationSet>& animationSet, float maxVelocityX);
+	bool despawn(EntityHandle handle);	// false if the handle is stale
+	void clear();	// every handle becomes stale
+	void reserve(std::size_t capacity);
+	[[nodiscard]] std::size_t size() const { return kinds.size(); }
+
+	[[nodiscard]] std::size_t indexOf(EntityHandle handle) const;	// NO_ENTITY if the handle is stale
+	[[nodiscard]] EntityHandle handleOf(std::size_t entity) const;
+	[[nodiscard]] bool isValid(EntityHandle handle) const { return indexOf(handle) != NO_ENTITY; }
+
+	// Broadphase over the hitboxes, results are dense indexes appended to the vector
+	void query(const Box& region, std::vector<std::size_t>& entities) const;
+	void pick(const sf::Vector2f& point, std::vector<std::size_t>& entities) const;
+	void findOverlappingPairs(std::vector<std::pair<std::size_t, std::size_t>>& pairs) const;
+
+	// Systems, active entities only
+	void updateKinematics(float dt);	// movement wanted for this frame, see Kinematics
+	void updateHealth(float dt);
+	void updateAnimations(float dt);
+
+	// State changes, applying the same rules as the systems
+	void setPosition(std::size_t entity, const sf::Vector2f& position);
+	void setWalkingState(std::size_t entity, WalkingState walkingState);
+	void setYState(std::size_t entity, YState state);
+	void takeDamage(std::size_t entity, unsigned int amount);
+	void setInvincible(std::size_t entity, bool invincible, float time = 1.f);
+	[[nodiscard]] bool isAlive(std::size_t entity) const { return healths[entity].hp > 0; }
+
+	/** Copy of the entities and their handles, to come back to this state later (replay keyframes).
+	 *  Drawing state (texture, interpolation) isn't part of it **/
+	struct Snapshot
+	{
+		std::vector<EntityKind> kinds;
+		std::vector<std::uint8_t> active;
+		std::vector<sf::Vector2f> positions;
+		std::vector<sf::Vector2f> previousPositions;
+		std::vector<Box> hitboxes;
+		std::vector<Kinematics> kinematics;
+		std::vector<Health> healths;
+		std::vector<AnimationState> animations;
+
+		std::vector<std::uint32_t> slotToIndex;
+		std::vector<std::uint32_t> generations;
+		std::vector<std::uint32_t> freeSlots;
+		std::vector<std::uint32_t> indexToSlot;
+		SpatialHash broadphase{ 1.f };
+		std::vector<std::pair<std::shared_ptr<const AnimationSet>, AnimationClips>> animationSets;	// keeps AnimationState::set alive
+	};
+	void save(Snapshot& snapshot) const;	// reuses the snapshot memory
+	void restore(const Snapshot& snapshot);	// handles taken since save() become stale or invalid
+
+	// Interpolation: draw() places entities between previousPositions and positions
+	void storePreviousPositions();	// at the beginning of each simulation step
+	void setInterpolation(float interpolation) { m_interpolation = interpolation; }	// 0: previous, 1: current
+
+	// Drawing, one kind at a time to fit in the scene layers: one batched draw call per kind
+	void draw(sf::RenderTarget& target, sf::RenderStates states, EntityKind kind) const;
+
+	/** Drawable drawing the entities of a single kind **/
+	class KindLayer : public sf::Drawable
+	{
+	public:
+		KindLayer(const World& world, EntityKind kind) : m_world(world), m_kind(kind) {}
+
+	private:
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override { m_world.draw(target, states, m_kind); }
+
+		const World& m_world;
+		EntityKind m_kind;
+	};
+
+	// Components
+	std::vector<EntityKind> kinds;
+	std::vector<std::uint8_t> active;	// 0: frozen (e.g. its chunk isn't streamed in), skipped by the systems
+	std::vector<sf::Vector2f> positions;
+	std::vector<sf::Vector2f> previousPositions;	// positions before the current simulation step
+	std::vector<Box> hitboxes;	// absolute: position + current frame size. Written through World only: see m_broadphase
+	std::vector<Kinematics> kinematics;
+	std::vector<Health> healths;
+	std::vector<AnimationState> animations;
+
+private:
+	void setAnimation(std::size_t entity, AnimationId id);
+	void syncBroadphase(std::size_t entity) { m_broadphase.update(m_indexToSlot[entity], hitboxes[entity]); }
+
+	const sf::Texture* m_texture = nullptr;
+	float m_interpolation = 1.f;
+	mutable SpriteBatch m_batch;	// visible entities of the kind being drawn, rebuilt by each draw()
+
+	// Handles
+	std::vector<std::uint32_t> m_slotToIndex;	// dense index of each slot's entity
+	std::vector<std::uint32_t> m_generations;	// current generation of each slot
+	std::vector<std::uint32_t> m_freeSlots;
+	std::vector<std::uint32_t> m_indexToSlot;	// parallel to the components
+
+	// Hitboxes by slot, updated whenever one moves or resizes
+	SpatialHash m_broadphase;
+	mutable std::vector<std::uint32_t> m_querySlots;	// reused buffer
+	mutable std::vector<std::pair<std::uint32_t, std::uint32_t>> m_querySlotPairs;
+
+	// Animation sets of AnimationState, kept alive, with their clips resolved once
+	struct SharedAnimationSet
+	{
+		std::shared_ptr<const AnimationSet> set;
+		AnimationClips clips;
+	};
+	std::vector<SharedAnimationSet> m_animationSets;
+};
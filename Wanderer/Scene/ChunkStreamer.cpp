@@ -0,0 +1,129 @@
+#include "Scene/ChunkStreamer.hpp"
+#include "Scene/Map.hpp"
+#include "Utility/Profiler.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+ChunkStreamer::ChunkStreamer(std::unique_ptr<LevelFile> levelFile, const Map& map, const std::vector<TileId>& slotToTile, TileId defaultTile)
+	: m_levelFile(std::move(levelFile))
+	, m_map(map)
+	, m_slotToTile(slotToTile)
+	, m_defaultTile(defaultTile)
+{
+	for (std::size_t i = 0; i < m_levelFile->getChunkCount(); ++i)
+	{
+		const sf::Vector2i coords = m_levelFile->getChunkCoords(i);
+		m_directory[makeChunkKey(coords.x, coords.y)] = i;
+	}
+
+	m_worker = std::thread(&ChunkStreamer::run, this);
+}
+
+ChunkStreamer::~ChunkStreamer()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wakeUp.notify_one();
+	m_worker.join();
+}
+
+bool ChunkStreamer::isPending(ChunkKey key) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_pending.count(key) != 0;
+}
+
+sf::IntRect ChunkStreamer::getTileBounds() const
+{
+	if (m_directory.empty())
+		return {};
+
+	sf::Vector2i min = chunkFromKey(m_directory.begin()->first);
+	sf::Vector2i max = min;
+	for (const auto& entry : m_directory)
+	{
+		const sf::Vector2i c = chunkFromKey(entry.first);
+		min.x = std::min(min.x, c.x);
+		min.y = std::min(min.y, c.y);
+		max.x = std::max(max.x, c.x);
+		max.y = std::max(max.y, c.y);
+	}
+
+	return { min.x * CHUNK_SIZEi, min.y * CHUNK_SIZEi, (max.x - min.x + 1) * CHUNK_SIZEi, (max.y - min.y + 1) * CHUNK_SIZEi };
+}
+
+void ChunkStreamer::request(ChunkKey key)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_pending.insert(key).second)
+			return;
+		m_jobs.push_back(key);
+	}
+	m_wakeUp.notify_one();
+}
+
+bool ChunkStreamer::loadNow(ChunkKey key, TileChunk& chunk) const
+{
+	auto it = m_directory.find(key);
+	if (it == m_directory.end())
+		return false;
+
+	std::vector<std::uint8_t> cells;
+	if (!m_levelFile->decodeChunk(it->second, cells))
+		return false;
+
+	for (std::size_t i = 0; i < cells.size(); ++i)
+		chunk.tiles[i] = m_slotToTile[cells[i]];
+
+	const sf::Vector2i coords = chunkFromKey(key);
+	m_map.indexChunk(chunk);
+	m_map.meshChunk(chunk, coords * CHUNK_SIZEi);
+	return true;
+}
+
+void ChunkStreamer::collect(std::vector<std::pair<ChunkKey, TileChunk>>& ready)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto& done : m_done)
+	{
+		m_pending.erase(done.first);
+		ready.push_back(std::move(done));
+	}
+	m_done.clear();
+}
+
+void ChunkStreamer::run()
+{
+	Profiler::setThreadName("chunk streamer");
+	for (;;)
+	{
+		ChunkKey key;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeUp.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+			if (m_stop)
+				return;
+
+			key = m_jobs.front();
+			m_jobs.pop_front();
+		}
+
+		// Decoding and meshing only read the mapped file and the tiles registry
+		TileChunk chunk(m_defaultTile);
+		bool loaded;
+		{
+			PROFILE_ZONE("stream chunk");
+			loaded = loadNow(key, chunk);
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (loaded)
+			m_done.emplace_back(key, std::move(chunk));
+		else
+			m_pending.erase(key);	// corrupted, reported by LevelFile
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Scene/LevelFile.hpp"
+#include "Scene/TileChunk.hpp"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+class Map;
+
+/** Decodes and meshes the chunks of a binary level on a background thread.
+ *  Residency (what to request, what to evict) is decided by Map::updateStreaming() **/
+class ChunkStreamer
+{
+public:
+	ChunkStreamer(std::unique_ptr<LevelFile> levelFile, const Map& map, const std::vector<TileId>& slotToTile, TileId defaultTile);
+	~ChunkStreamer();
+	ChunkStreamer(const ChunkStreamer&) = delete;
+	ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+	[[nodiscard]] bool contains(ChunkKey key) const { return m_directory.count(key) != 0; }
+	[[nodiscard]] bool isPending(ChunkKey key) const;
+	[[nodiscard]] const std::unordered_map<ChunkKey, std::size_t>& getDirectory() const { return m_directory; }
+	[[nodiscard]] sf::IntRect getTileBounds() const;	// union of every chunk of the file, in tiles
+
+	void request(ChunkKey key);		// asynchronous, ignored if already pending
+	bool loadNow(ChunkKey key, TileChunk& chunk) const;	// synchronous
+	void collect(std::vector<std::pair<ChunkKey, TileChunk>>& ready);	// moves out the chunks done since last call
+
+	void setRadius(int radius) { m_radius = radius; }
+	[[nodiscard]] int getRadius() const { return m_radius; }
+	[[nodiscard]] std::size_t getCapacity() const { return (std::size_t)(2 * m_radius + 1) * (2 * m_radius + 1) * 2; }
+
+private:
+	void run();	// worker thread
+
+	std::unique_ptr<LevelFile> m_levelFile;	// stays mapped while streaming
+	std::unordered_map<ChunkKey, std::size_t> m_directory;	// chunk key to file chunk index
+	const Map& m_map;
+	const std::vector<TileId> m_slotToTile;
+	const TileId m_defaultTile;
+	int m_radius = STREAMING_RADIUS;
+
+	// Shared with the worker
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wakeUp;
+	std::deque<ChunkKey> m_jobs;
+	std::unordered_set<ChunkKey> m_pending;		// queued, in progress or done but not collected
+	std::vector<std::pair<ChunkKey, TileChunk>> m_done;
+	bool m_stop = false;
+
+	std::thread m_worker;	// last: started once everything above is ready
+};
@@ -1,7 +1,10 @@
 #include "Editor/MapEditor.hpp"
 #include "Scene/GameScene.hpp"
+#include "Scene/RenderStats.hpp"
 #include "Constants.hpp"
 #include "Utility/util.hpp"
+#include "Utility/Logger.hpp"
+#include "Utility/Profiler.hpp"
 
 #include <iostream>
 #include <cassert>
@@ -9,12 +12,10 @@
 
 #include <imgui-SFML.h>
 #include <imgui.h>
-#include <nlohmann/json.hpp>
 
 
 GameScene::GameScene(sf::RenderWindow* window)
 	: Scene(window)
-	, m_map(m_tilesMgr)
 {
 	// ------------------- textures (resource: loaded once) -------------------
 	m_tileset.loadFromFile(TEXTURES_PATH + "tileset.png");
@@ -26,28 +27,25 @@ GameScene::GameScene(sf::RenderWindow* window)
 
 	// Setting up player health box in the update function updateHealthBox()
 	m_PHB.setFillColor(sf::Color::Red);
-	m_layers["game_gui"].addObject(&m_PHBOutline);
-	m_layers["game_gui"].addObject(&m_PHB);
+	getLayer(RenderLayer::Gui).addCulledObject(&m_PHBOutline);
+	getLayer(RenderLayer::Gui).addCulledObject(&m_PHB, 1);	// over its outline
 
 	// TODO: debug purpose
-	m_mapEditor = new MapEditor(*this, m_tilesMgr);
+	m_mapEditor = new MapEditor(*this, m_simulation.getTilesManager());
 }
 
 GameScene::~GameScene()
 {
 	delete m_mapEditor;
-	destroyEntities();
 }
 
-void GameScene::loadLevel(const std::string& levelFilename)
+void GameScene::loadLevel(const std::string& levelFilename, bool importText)
 {
 	// reset
-	m_layers["backgroundLayer"].clear();
-	m_layers["mapLayer"].clear();
-	m_layers["mobsLayer"].clear();
-	m_layers["playerLayer"].clear();
-	destroyEntities();
-	m_tilesMgr.clearTiles();
+	getLayer(RenderLayer::Background).clear();
+	getLayer(RenderLayer::Map).clear();
+	getLayer(RenderLayer::Mobs).clear();
+	getLayer(RenderLayer::Player).clear();
 	// TODO: dirty: can't reset position because background changed as the player is (initially) centered (placeCameraOnPlayer)
 	// m_background.resetPosition();
 
@@ -55,37 +53,27 @@ void GameScene::loadLevel(const std::string& levelFilename)
 
 	// background
 	m_background.getSprite()->setTexture(m_backgroundTexture);
-	m_layers["backgroundLayer"].addObject(m_background.getDrawable());
+	getLayer(RenderLayer::Background).addCulledObject(m_background.getSprite());
 
-	// Tiles
-	// Important: load tiles before map because map uses the tiles (obviously!)
-	m_tilesMgr.loadTiles(TEXTURES_PATH + "tilesData.json");	// Setting up pointers before creating map
+	// Map and entities
+	m_levelFilename = levelFilename;
+	const bool loaded = m_simulation.loadLevel(levelFilename, importText);
+	m_simulation.getMap().setTexture(m_tileset);
+	m_simulation.getWorld().setTexture(m_tileset);
 
-	// Map
-	m_map.setTexture(m_tileset);
-	m_map.load(levelFilename + "/map.txt");
-
-	// Entities
-	loadEntities(levelFilename + "/entities.json");
-	m_layers["mapLayer"].addObject(&m_map);
+	// These cull their content themselves
+	getLayer(RenderLayer::Map).addObject(&m_simulation.getMap());
+	getLayer(RenderLayer::Mobs).addObject(&m_enemiesDrawable);
+	getLayer(RenderLayer::Player).addObject(&m_playerDrawable);
 
 	// reset camera
 	m_window->setView(m_window->getDefaultView());
+	m_previousCameraCenter = m_window->getView().getCenter();	// no interpolation from the previous level
+	m_PHBUpdateWidth = true;
 
 	// Player should be registered after loading
-	assert(m_player);
-}
-
-void GameScene::destroyEntities()
-{
-	m_player = nullptr;
-	m_enemies.clear();
-
-	while (!m_entities.empty())
-	{
-		delete m_entities.back();
-		m_entities.pop_back();
-	}
+	assert(loaded);
+	(void)loaded;
 }
 
 void GameScene::setReadEvents(bool read)
@@ -119,10 +107,11 @@ void GameScene::updateHealthBox(float dt)
 
 	if (m_PHBUpdateWidth)
 	{
-		std::cout << "Updating PHB!" << std::endl;
+		LOG(Trace, "Updating PHB!");	// every frame of the animation
 
 		float PHBMaxWidth = obw - 2 * padding;
-		if (m_player->getHp() == m_player->getMaxHp())
+		const Health& playerHealth = m_simulation.getWorld().healths[getPlayer()];
+		if (playerHealth.hp == playerHealth.maxHp)
 		{
 			// Set up full health bar for first time
 			m_PHB.setSize({ PHBMaxWidth, obh - 2 * padding });
@@ -131,7 +120,7 @@ void GameScene::updateHealthBox(float dt)
 		else
 		{
 			// Adjusted width
-			float ratio = (float)m_player->getHp() / (float)m_player->getMaxHp();
+			float ratio = (float)playerHealth.hp / (float)playerHealth.maxHp;
 			float targetWidth = ratio * PHBMaxWidth;
 			float currentWidth = m_PHB.getSize().x;
 			float dx = m_PHBVelocity * dt * sign(targetWidth - currentWidth);
@@ -170,7 +159,7 @@ void GameScene::handleEvent(const sf::Event& event)
 		if (event.key.code == sf::Keyboard::W)
 		{
 			auto mousePosition = m_window->mapPixelToCoords(sf::Mouse::getPosition(*m_window));
-			std::cout << "mouse position: " << mousePosition.x << " ; " << mousePosition.y << std::endl;
+			LOG(Info, "mouse position: %f ; %f", mousePosition.x, mousePosition.y);
 		}
 		else if (event.key.code == sf::Keyboard::E)
 		{
@@ -180,7 +169,7 @@ void GameScene::handleEvent(const sf::Event& event)
 				m_mapEditor = nullptr;
 			}
 			else
-				m_mapEditor = new MapEditor(*this, m_tilesMgr);
+				m_mapEditor = new MapEditor(*this, m_simulation.getTilesManager());
 		}
 	}
 
@@ -199,218 +188,137 @@ void GameScene::checkInput()
 	if (sf::Keyboard::isKeyPressed(sf::Keyboard::D))
 		__debugbreak();
 
-	else if (sf::Keyboard::isKeyPressed(sf::Keyboard::H))
+	else if (sf::Keyboard::isKeyPressed(sf::Keyboard::H) && !m_recording && !m_replayPlayer)	// not an input: can't be replayed
 	{
-		m_player->setHp(100);
+		Health& playerHealth = m_simulation.getWorld().healths[getPlayer()];
+		playerHealth.hp = playerHealth.maxHp;
 		m_PHBUpdateWidth = true;
 	}
+}
 
-	if (!m_readEvents)
-		return;
-
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
-	{
-		m_player->setFacing(Direction::Right);
-		m_player->setWalkingState(WalkingState::Beginning);
-	}
-	else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
-	{
-		m_player->setFacing(Direction::Left);
-		m_player->setWalkingState(WalkingState::Beginning);
-	}
-	else
-		m_player->setWalkingState(WalkingState::End);
+PlayerInput GameScene::readKeyboard()
+{
+	PlayerInput input;
+	input.right = sf::Keyboard::isKeyPressed(sf::Keyboard::Right);
+	input.left = sf::Keyboard::isKeyPressed(sf::Keyboard::Left);
+	input.jump = sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
+	input.up = sf::Keyboard::isKeyPressed(sf::Keyboard::Up);
+	input.down = sf::Keyboard::isKeyPressed(sf::Keyboard::Down);
+	return input;
+}
 
+void GameScene::update(float dt)
+{
+	// Drawing interpolates the camera from its position before this step
+	m_previousCameraCenter = m_window->getView().getCenter();
 
-	// Check for jump
-	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space))
-		m_player->setYState(YState::Jumping);
+	// Keys held during this step, not during the frame: several steps may run per frame, or none
+	if (m_readEvents)
+		m_input = readKeyboard();
 
-	// Check for ladder
-	else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up) && m_map.touchingTile(m_player->getHitbox(), Tile::Property::Ladder))
-	{
-		m_player->setYState(YState::Climbing);
-		m_player->setClimbingDirection(Direction::Up);
-	}
-	else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down) && m_map.touchingTile(m_player->getHitbox(), Tile::Property::Ladder))
+	if (m_replayPlayer)
 	{
-		m_player->setYState(YState::Climbing);
-		m_player->setClimbingDirection(Direction::Down);
+		if (!m_replayPaused)
+			m_replayPlayer->step();
 	}
-	else if (m_map.touchingTile(m_player->getHitbox(), Tile::Property::Ladder))
-		m_player->setClimbingDirection(Direction::None);
-}
-
-void GameScene::update(float dt)
-{	 
-	m_lastDt = dt;
-
-	// Enemy collision
-	if (!m_player->isInvicible())
+	else
 	{
-		for (auto enemy : m_enemies)
-		{
-			if (boxesOverlapping(enemy->getHitbox(), m_player->getHitbox()))
-			{
-				if (m_player->isAlive())
-				{
-					m_player->takeDamage(20);
-					m_player->setIsInvicible(true, 1.f);
-
-					// Animation request
-					m_PHBUpdateWidth = true;
-				}
-			}
-		}
+		m_simulation.step(m_input, dt);
+		if (m_recording)
+			m_replay.record(m_input, m_simulation);
 	}
 
-	// internal player update
-	m_player->update(dt);
-
-	// external player update
-	updateClimbingState(*m_player);
-	moveEntity(*m_player);
-
-	// enemies update
-	for (auto enemy : m_enemies)
+	// The health box animates whenever the player's hp changed (contact damage, healing...)
+	const unsigned int hp = m_simulation.getWorld().healths[getPlayer()].hp;
+	if (hp != m_PHBLastHp)
 	{
-		enemy->update(dt);
-		// no updateClimbingState because entities can't climb ladders
-		moveEnemy(*enemy);
+		m_PHBLastHp = hp;
+		m_PHBUpdateWidth = true;
 	}
 
 	updateCamera();
+	m_simulation.updateStreaming(m_window->getView().getCenter());
 	updateHealthBox(dt);
 }
 
-void GameScene::updateClimbingState(MovingCharacter& entity)
+void GameScene::startRecording()
 {
-	if (entity.getYState() == YState::Climbing && !m_map.touchingTile(m_player->getHitbox(), Tile::Property::Ladder))
-		entity.setYState(YState::Falling);
+	stopPlayback();
+	loadLevel(m_levelFilename);
+	m_simulation.getMap().stopStreaming();	// see ReplayPlayer::start()
+	m_replay.clear(m_levelFilename);
+	m_recording = true;
 }
 
-void GameScene::loadEntities(const std::string& entitiesFilename)
+void GameScene::stopRecording(const std::string& filename)
 {
-	std::ifstream stream(entitiesFilename);
-	if (stream)
-	{
-		auto registerEntity = [&](const std::string& entityType, float x, float y)
-		{
-			if (entityType == "player")
-			{
-				// Allocation
-				assert(!m_player);	// m_player should be initialized once per level loading
-				m_player = new Player();
-				m_entities.push_front(m_player);
-
-				m_player->setPosition(x, y);
-				m_player->setTexture(m_tileset);
-				m_layers["playerLayer"].addObject(m_player);
-			}
-			else if (entityType == "enemy")
-			{
-				// Allocation
-				auto* enemy = new Enemy();
-				m_enemies.push_back(enemy);
-				m_entities.push_back(enemy);
-
-				enemy->setPosition(x, y);
-				enemy->setTexture(m_tileset);
-				m_layers["mobsLayer"].addObject(enemy);
-			}
-			else
-				std::cerr << "!!! Calling loadEntities with name type=" << entityType << "!!!" << std::endl;
-		};
+	if (!m_recording)
+		return;
 
-		nlohmann::json data;
-		stream >> data;
+	m_recording = false;
+	if (m_replay.save(filename))
+		LOG(Info, "Replay of %llu ticks saved to %s", (unsigned long long)m_replay.getTickCount(), filename.c_str());
+}
 
-		// Loading the player
-		registerEntity("player", data["player"][0], data["player"][1]);
+void GameScene::startPlayback(const std::string& filename)
+{
+	m_recording = false;
+	m_replayPlayer.reset();
+	if (!m_replay.load(filename))
+		return;
 
-		// Loading the entities
-		for (const auto& enemy : data["enemies"])
-			registerEntity("enemy", enemy[0], enemy[1]);
-	}
-	else
-	{
-		std::cerr << "Failed to open: " << entitiesFilename << std::endl;
-	}
+	loadLevel(m_replay.getLevel());
+	m_replayPlayer = std::make_unique<ReplayPlayer>(m_simulation, m_replay);
+	m_replayPaused = false;
+	if (!m_replayPlayer->start())
+		m_replayPlayer.reset();
 }
 
-void GameScene::moveEntity(MovingCharacter& entity, bool* xCollision)
+void GameScene::stopPlayback()
 {
-	Box hitbox = entity.getHitbox();
+	m_replayPlayer.reset();
+}
 
-	float dx = entity.getMovement().x;
-	float dy = entity.getMovement().y;
+void GameScene::drawReplayGui()
+{
+	ImGui::Separator();
+	const char* filename = "replay.wrpl";
 
-	// Y checking
-	if (dy != 0.f)
+	if (m_replayPlayer)
 	{
-		if (std::abs(dy) >= TILE_SIZEf)
+		// Seeking moves the player: no camera interpolation from where it was
+		int tick = (int)m_replayPlayer->getTick();
+		if (ImGui::SliderInt("Replay tick", &tick, 0, (int)m_replay.getTickCount()))
 		{
-			//std::cout << "dy=" << dy;
-			dy = (TILE_SIZEf - 1.f) * ((dy < 0) ? -1.f : 1.f);	// maximum dy with care of sign
-			//std::cout << " -> " << dy << std::endl;
+			m_replayPlayer->seek((std::uint64_t)tick);
+			updateCamera();
+			m_previousCameraCenter = m_window->getView().getCenter();
+			m_PHBUpdateWidth = true;
 		}
+		ImGui::Checkbox("Pause", &m_replayPaused);
 
-		if (!m_map.touchingTile({hitbox.x, hitbox.y+dy, hitbox.w, hitbox.h}, Tile::Property::Solid))
-			hitbox.y += dy;
+		if (m_replayPlayer->getDivergentTick() != ReplayPlayer::NO_DIVERGENCE)
+			ImGui::TextColored({ 1.f, 0.3f, 0.3f, 1.f }, "Diverged at tick %llu", (unsigned long long)m_replayPlayer->getDivergentTick());
 		else
-		{
-			if (entity.getYState() == YState::Falling)
-			{
-				hitbox.y = std::ceil((hitbox.y + hitbox.h - 1.f) / TILE_SIZEf) * TILE_SIZEf - hitbox.h;
-				entity.setYState(YState::Grounded);
-			}
-			else if (entity.getYState() == YState::Jumping)
-			{
-				//std::cout << "block ahead keeping from jumping higher" << std::endl;
-				entity.setYState(YState::Falling);
-			}
-		}
-	}
+			ImGui::Text("%s", m_replayPlayer->isFinished() ? "Finished, in sync" : "In sync");
 
-	// X checking
-	if (dx != 0.f)
+		if (ImGui::Button("Take control"))
+			stopPlayback();
+	}
+	else if (m_recording)
 	{
-		if (std::abs(dx) >= TILE_SIZEf)
-		{
-			//std::cout << "dx=" << dx;
-			dx = (TILE_SIZEf - 1.f) * ((dx < 0) ? -1.f : 1.f);	// maximum dx with care of sign
-			//std::cout << " -> " << dx << std::endl;
-		}
-
-		if (!m_map.touchingTile({hitbox.x+dx, hitbox.y, hitbox.w, hitbox.h}, Tile::Property::Solid))
-			hitbox.x += dx;
-		else
-		{
-			if (dx > 0)
-				hitbox.x = std::ceil((hitbox.x + hitbox.w - 1.f) / TILE_SIZEf) * TILE_SIZEf - hitbox.w;
-			else
-				hitbox.x = std::floor(hitbox.x / TILE_SIZEf) * TILE_SIZEf;
-
-			if (xCollision)
-				*xCollision = true;
-		}
-
-		if (entity.getYState() == YState::Grounded && !m_map.touchingTile({ hitbox.x, hitbox.y + 2.f, hitbox.w, hitbox.h }, Tile::Property::Solid))
-		{
-			//std::cerr << "moving aside made the player fall" << std::endl;
-			entity.setYState(YState::Falling);
-		}
+		ImGui::Text("Recording: %llu ticks", (unsigned long long)m_replay.getTickCount());
+		if (ImGui::Button("Stop and save"))
+			stopRecording(filename);
+	}
+	else
+	{
+		if (ImGui::Button("Record replay"))
+			startRecording();
+		ImGui::SameLine();
+		if (ImGui::Button("Play replay.wrpl"))
+			startPlayback(filename);
 	}
-
-	entity.setPosition(hitbox.x, hitbox.y);
-}
-
-void GameScene::moveEnemy(Enemy& enemy)
-{
-	bool xCollision = false;
-	moveEntity(enemy, &xCollision);
-	if (xCollision)
-		enemy.toggleFacing();
 }
 
 void GameScene::setCameraOnPlayer(bool value)
@@ -434,7 +342,7 @@ void GameScene::placeCameraOnPlayer()
 {
 	sf::View currentView = m_window->getView();
 
-	auto& playerBox = m_player->getHitbox();
+	const Box& playerBox = m_simulation.getWorld().hitboxes[getPlayer()];
 	sf::Vector2f playerCenter(playerBox.x + playerBox.w / 2, playerBox.y + playerBox.h / 2);
 	sf::Vector2f vecCenter = playerCenter - currentView.getCenter();
 
@@ -495,29 +403,55 @@ void GameScene::moveCameraIfMouseOnEdge()
 		moveCamera(translation);
 }
 
-void GameScene::draw(sf::RenderTarget& target)
+void GameScene::draw(sf::RenderTarget& target, float interpolation)
 {
-	target.draw(m_layers["backgroundLayer"]);
-	target.draw(m_layers["mapLayer"]);
-	target.draw(m_layers["mobsLayer"]);
-	target.draw(m_layers["playerLayer"]);
-	target.draw(m_layers["game_gui"]);
+	// The scene is drawn between the last two simulation steps, camera included
+	const sf::View simulatedView = target.getView();
+	sf::View view = simulatedView;
+	view.setCenter(m_previousCameraCenter + (simulatedView.getCenter() - m_previousCameraCenter) * interpolation);
+	target.setView(view);
+	m_simulation.getWorld().setInterpolation(interpolation);
 
+	// The background follows the camera in placeCameraOnPlayer(), it lags behind it the same way
+	const sf::Vector2f cameraLag = view.getCenter() - simulatedView.getCenter();
+	m_background.move(cameraLag);
+
+	{
+		PROFILE_ZONE("layers");
+		const std::size_t guiLayer = static_cast<std::size_t>(RenderLayer::Gui);
+		for (std::size_t i = 0; i < m_layers.size(); ++i)
+		{
+			if (i == guiLayer)
+				target.setView(simulatedView);	// placed from the simulated camera (updateHealthBox)
+
+			RenderStats::setGroup(RENDER_LAYER_NAMES[i]);
+			target.draw(m_layers[i]);
+		}
+	}
+
+	m_background.move(-cameraLag);
+	target.setView(simulatedView);	// the editor and the gui work with the simulated camera
+
+	RenderStats::setGroup("editor");
 	if (m_mapEditor)
 		m_mapEditor->render();
 
 	if (m_imguiEnabled)
 	{
-		ImGui::Text("Frame took %f FPS=%f", m_lastDt * 1000.f, 1 / m_lastDt);
+		// Formatted by ImGui: no string built every frame
 		const sf::Vector2i mpos = sf::Mouse::getPosition(*m_window);
-		std::ostringstream ss;
-		ss << "Absolute cursor position: " << mpos.x << " ; " << mpos.y << '\n';
 		auto top_left = m_window->mapPixelToCoords({ 0, 0 });
-		ss << "Translated cursor position: "
-            << top_left.x + static_cast<float>(mpos.x)
-            << " ; "
-            << top_left.y + static_cast<float>(mpos.y);
-		ImGui::Text("%s", ss.str().c_str());
+		ImGui::Text("Absolute cursor position: %d ; %d", mpos.x, mpos.y);
+		ImGui::Text("Translated cursor position: %g ; %g", top_left.x + static_cast<float>(mpos.x), top_left.y + static_cast<float>(mpos.y));
+
+		if (m_simulation.getMap().isStreaming())
+		{
+			int radius = m_simulation.getMap().getStreamingRadius();
+			if (ImGui::SliderInt("Streaming radius", &radius, 1, 8))
+				m_simulation.getMap().setStreamingRadius(radius);
+			ImGui::Text("Resident chunks: %zu", m_simulation.getMap().getChunkCount());
+		}
+		drawReplayGui();
 		//ImGui::ShowDemoWindow();
 	}
 }
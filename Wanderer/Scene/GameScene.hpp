@@ -1,32 +1,32 @@
 #pragma once
 
 #include "Scene.hpp"
-#include "Scene/Map.hpp"
-#include "Entity/Player.hpp"
-#include "Entity/Enemy.hpp"
+#include "Scene/Simulation.hpp"
+#include "Scene/Replay.hpp"
 #include "Scene/Layer.hpp"
 #include "Scene/Background.hpp"
-#include "Scene/TilesManager.hpp"
 
-#include <list>
+#include <array>
+#include <cstdint>
 #include <memory>
 
 class MapEditor;
 
-/** The GameScene is composed of a map and entities, including the player **/
+/** The GameScene presents a Simulation (map and entities, including the player) in a window and feeds it the keyboard **/
 class GameScene : public Scene
 {
 public:
 	explicit GameScene(sf::RenderWindow* window);
 	~GameScene() override;
 
-	void loadLevel(const std::string& levelFilename);
+	// Loads level.bin from the level directory, or map.txt + entities.json if there is none (or if importText)
+	void loadLevel(const std::string& levelFilename, bool importText = false);
 
 	// ----- Scene overwritten methods -----
 	void handleEvent(const sf::Event& event) override;
 	void checkInput() override;
 	void update(float dt) override;
-	void draw(sf::RenderTarget& target) override;
+	void draw(sf::RenderTarget& target, float interpolation) override;
 	
 	// ----- Behavior -----
 	void setReadEvents(bool read);
@@ -35,12 +35,17 @@ public:
 	// ---- Gui management -----
 	void updateHealthBox(float dt);
 
-	// ----- Entity management -----
-	void loadEntities(const std::string& entitiesFilename);
-	void destroyEntities();
-	void moveEntity(MovingCharacter& entity, bool* xCollision = nullptr);
-	void updateClimbingState(MovingCharacter& entity);
-	void moveEnemy(Enemy& enemy);
+	// ----- Game logic -----
+	Simulation& getSimulation() { return m_simulation; }
+	[[nodiscard]] std::size_t getPlayer() const { return m_simulation.getPlayer(); }	// dense index of the player
+	static PlayerInput readKeyboard();
+
+	// ----- Replays -----
+	void startRecording();	// restarts the level: a replay begins with it
+	void stopRecording(const std::string& filename);
+	void startPlayback(const std::string& filename);
+	void stopPlayback();	// the game goes on from the current replay tick
+	void drawReplayGui();
 
 	// ----- Camera management -----
 	void setCameraOnPlayer(bool v = true);
@@ -56,15 +61,25 @@ private:
 	sf::Texture m_tileset;
 	sf::Texture m_backgroundTexture;
 
-	// Layers
-	std::map<std::string, Layer> m_layers;
+	// Layers, drawn in this order
+	enum class RenderLayer : std::uint8_t { Background, Map, Mobs, Player, Gui, Count };
+	static constexpr std::array<const char*, static_cast<std::size_t>(RenderLayer::Count)> RENDER_LAYER_NAMES = { "background", "map", "mobs", "player", "gui" };	// RenderStats groups
+	Layer& getLayer(RenderLayer layer) { return m_layers[static_cast<std::size_t>(layer)]; }
+	std::array<Layer, static_cast<std::size_t>(RenderLayer::Count)> m_layers;
 	Background m_background;
-	Map m_map;
 
-	// Entities storage
-	std::list<GameObject*> m_entities;	// "ownership" of heap pointers
-	Player* m_player = nullptr;
-	std::list<Enemy*> m_enemies;
+	// Game logic
+	Simulation m_simulation;
+	PlayerInput m_input;	// sampled at each update(), kept while the editor has the mouse
+	std::string m_levelFilename;
+	World::KindLayer m_playerDrawable{ m_simulation.getWorld(), EntityKind::Player };
+	World::KindLayer m_enemiesDrawable{ m_simulation.getWorld(), EntityKind::Enemy };
+
+	// Replays
+	Replay m_replay;	// being recorded or played back
+	bool m_recording = false;
+	std::unique_ptr<ReplayPlayer> m_replayPlayer;	// nullptr: not playing back
+	bool m_replayPaused = false;
 
 	// Gui
 	// PHB = player health box
@@ -72,15 +87,15 @@ private:
 	sf::RectangleShape m_PHB;
 	const float m_PHBVelocity = 300.f;
 	bool m_PHBUpdateWidth = true;
+	unsigned int m_PHBLastHp = 0;	// the width animates when the player's hp changes
 
 	// Behavior
 	bool m_readEvents = true;
 	bool m_imguiEnabled = true;
-	float m_lastDt = 0.f;
+	sf::Vector2f m_previousCameraCenter;	// before the last simulation step
 	bool m_cameraOnPlayer = true;
 	const float m_screenPadding = 300.f;
 	const unsigned int m_mouseScreenPadding = 50;
 
-	TilesManager m_tilesMgr;
 	mutable MapEditor* m_mapEditor = nullptr;
 };
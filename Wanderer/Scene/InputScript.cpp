@@ -0,0 +1,69 @@
+#include "Scene/InputScript.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+bool InputScript::load(const std::string& filename)
+{
+	std::ifstream stream(filename);
+	if (!stream)
+	{
+		std::cerr << "Failed to open: " << filename << std::endl;
+		return false;
+	}
+
+	m_changes.clear();
+	std::string line;
+	for (int lineNumber = 1; std::getline(stream, line); ++lineNumber)
+	{
+		line = line.substr(0, line.find('#'));
+		std::istringstream words(line);
+
+		std::uint64_t tick;
+		if (!(words >> tick))
+			continue;	// blank or comment
+
+		PlayerInput input;
+		std::string control;
+		while (words >> control)
+		{
+			if (control == "left")			input.left = true;
+			else if (control == "right")	input.right = true;
+			else if (control == "jump")		input.jump = true;
+			else if (control == "up")		input.up = true;
+			else if (control == "down")		input.down = true;
+			else if (control != "-")
+				std::cerr << filename << ':' << lineNumber << ": unknown control '" << control << "', ignored" << std::endl;
+		}
+
+		if (!m_changes.empty() && tick <= m_changes.back().first)
+		{
+			std::cerr << filename << ':' << lineNumber << ": tick " << tick << " doesn't follow the previous one" << std::endl;
+			return false;
+		}
+		m_changes.emplace_back(tick, input);
+	}
+
+	return true;
+}
+
+void InputScript::add(std::uint64_t tick, const PlayerInput& input)
+{
+	if (!m_changes.empty() && m_changes.back().first == tick)
+		m_changes.back().second = input;	// several changes during the same tick: the last one wins
+	else
+		m_changes.emplace_back(tick, input);
+}
+
+PlayerInput InputScript::at(std::uint64_t tick) const
+{
+	// Last change at or before tick
+	auto it = std::upper_bound(m_changes.begin(), m_changes.end(), tick,
+							   [](std::uint64_t t, const std::pair<std::uint64_t, PlayerInput>& change) { return t < change.first; });
+	if (it == m_changes.begin())
+		return PlayerInput();
+	return std::prev(it)->second;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Scene/Simulation.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** Scripted player inputs for headless runs. Text file, one change per line:
+ *
+ *    <tick> <held controls: left right jump up down, or - for none>
+ *
+ *  Controls are held from that tick until the next line. Ticks must increase, # starts a comment **/
+class InputScript
+{
+public:
+	bool load(const std::string& filename);
+	void add(std::uint64_t tick, const PlayerInput& input);	// after every change already added
+
+	[[nodiscard]] PlayerInput at(std::uint64_t tick) const;
+	[[nodiscard]] std::uint64_t getLastTick() const { return m_changes.empty() ? 0 : m_changes.back().first; }
+	[[nodiscard]] bool empty() const { return m_changes.empty(); }
+	[[nodiscard]] const std::vector<std::pair<std::uint64_t, PlayerInput>>& getChanges() const { return m_changes; }
+	void clear() { m_changes.clear(); }
+
+private:
+	std::vector<std::pair<std::uint64_t, PlayerInput>> m_changes;	// sorted by tick
+};
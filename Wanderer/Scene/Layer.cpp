@@ -1,31 +1,45 @@
-#include <iostream>
+#include <algorithm>
 #include "Layer.hpp"
 
 void Layer::clear()
 {
-	m_drawables.clear();
+	m_entries.clear();
 }
 
-void Layer::addObject(const sf::Drawable* drawable)
+void Layer::addObject(const sf::Drawable* drawable, int sortKey)
 {
-//	std::cerr << "Adding (" << drawable << ") to some layer" << std::endl;
-	m_drawables.push_back(drawable);
+	insert({ drawable, nullptr, nullptr, nullptr, sortKey });
+}
+
+void Layer::insert(const Entry& entry)
+{
+	// After every entry of the same key: equal keys keep their insertion order
+	auto it = std::upper_bound(m_entries.begin(), m_entries.end(), entry.sortKey,
+							   [](int sortKey, const Entry& e) { return sortKey < e.sortKey; });
+	m_entries.insert(it, entry);
 }
 
 void Layer::removeObject(const sf::Drawable* drawableToRemove)
 {
-	for (auto it = m_drawables.begin(); it != m_drawables.end(); ++it)
-	{
-		if (*it == drawableToRemove)
-		{
-			m_drawables.erase(it);
-			break;
-		}
-	}
+	auto it = std::find_if(m_entries.begin(), m_entries.end(),
+						   [drawableToRemove](const Entry& e) { return e.drawable == drawableToRemove; });
+	if (it != m_entries.end())
+		m_entries.erase(it);
 }
 
 void Layer::draw(sf::RenderTarget& rt, sf::RenderStates states) const
 {
-	for (const sf::Drawable* drawable : m_drawables)
-		rt.draw(*drawable, states);
+	const sf::View& view = rt.getView();
+	const sf::FloatRect visible(view.getCenter() - view.getSize() / 2.f, view.getSize());
+
+	for (const Entry& entry : m_entries)
+	{
+		if (entry.bounds && !states.transform.transformRect(entry.bounds(entry.object)).intersects(visible))
+			continue;
+
+		if (entry.draw)
+			entry.draw(rt, entry.object, states);
+		else
+			rt.draw(*entry.drawable, states);
+	}
 }
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "Scene/RenderStats.hpp"
+
 #include <SFML/Graphics.hpp>
-#include <list>
+#include <vector>
 
+/** Ordered draw list. Objects are drawn by ascending sort key, in insertion order for equal keys.
+ * Objects added with bounds are skipped when they don't intersect the target's view **/
 class Layer : public sf::Drawable
 {
 public:
@@ -10,11 +14,35 @@ public:
 	~Layer() override = default;
 
 	void clear();
-	void addObject(const sf::Drawable* drawable);
+	void addObject(const sf::Drawable* drawable, int sortKey = 0);	// always drawn: for drawables culling themselves (e.g. Map)
 	void removeObject(const sf::Drawable* drawableToRemove);
 
+	// T: sf::Sprite or a sf::Shape, their draw calls are counted by RenderStats
+	template <typename T>
+	void addCulledObject(const T* object, int sortKey = 0)
+	{
+		insert({ object, object, [](const void* o) { return static_cast<const T*>(o)->getGlobalBounds(); },
+				 [](sf::RenderTarget& rt, const void* o, const sf::RenderStates& states) { RenderStats::draw(rt, *static_cast<const T*>(o), states); },
+				 sortKey });
+	}
+
+	[[nodiscard]] std::size_t getObjectCount() const { return m_entries.size(); }
+
 private:
+	typedef sf::FloatRect (*BoundsFunction)(const void* object);
+	typedef void (*DrawFunction)(sf::RenderTarget& rt, const void* object, const sf::RenderStates& states);
+
+	struct Entry
+	{
+		const sf::Drawable* drawable;
+		const void* object;		// what bounds is called with, nullptr if never culled
+		BoundsFunction bounds;
+		DrawFunction draw;	// nullptr: drawn as a sf::Drawable
+		int sortKey;
+	};
+
+	void insert(const Entry& entry);
 	void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
 
-	std::list<const sf::Drawable*> m_drawables;
+	std::vector<Entry> m_entries;	// sorted by sortKey
 };
@@ -0,0 +1,194 @@
+#include "Scene/LevelFile.hpp"
+#include "Utility/LittleEndian.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+
+namespace
+{
+	const char MAGIC[4] = { 'W', 'L', 'V', 'L' };
+	const std::size_t HEADER_SIZE = 20;
+	const std::size_t DIRECTORY_ENTRY_SIZE = 16;
+	const std::size_t ENTITY_SIZE = 9;
+	const int MAX_CHUNK_SIZE = 256;	// a chunk is decoded at once: 64k cells at most
+}
+
+bool LevelFile::open(const std::string& filename)
+{
+	close();
+
+	if (!m_file.open(filename))
+		return false;	// no binary level, not an error
+
+	m_filename = filename;
+
+	const unsigned char* data = m_file.data();
+	const std::size_t size = m_file.size();
+
+	auto fail = [&](const char* reason)
+	{
+		std::cerr << "LevelFile: " << filename << ": " << reason << std::endl;
+		close();
+		return false;
+	};
+
+	// Header
+	if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+		return fail("not a level file");
+	if (readU16(data + 4) != VERSION)
+		return fail("unsupported version");
+
+	m_chunkSize = readU16(data + 6);
+	const std::uint32_t paletteSize = readU32(data + 8);
+	const std::uint32_t chunkCount  = readU32(data + 12);
+	const std::uint32_t entityCount = readU32(data + 16);
+
+	if (m_chunkSize == 0 || m_chunkSize > MAX_CHUNK_SIZE || paletteSize > 256)
+		return fail("corrupted header");
+
+	const std::size_t tablesSize = HEADER_SIZE + paletteSize
+		+ (std::size_t)chunkCount * DIRECTORY_ENTRY_SIZE
+		+ (std::size_t)entityCount * ENTITY_SIZE;
+	if (size < tablesSize)
+		return fail("truncated");
+
+	// Palette
+	const unsigned char* p = data + HEADER_SIZE;
+	m_palette.assign(reinterpret_cast<const char*>(p), paletteSize);
+	p += paletteSize;
+
+	// Chunk directory
+	m_directory.reserve(chunkCount);
+	std::unordered_set<std::uint64_t> coords;
+	coords.reserve(chunkCount);
+	for (std::uint32_t i = 0; i < chunkCount; ++i, p += DIRECTORY_ENTRY_SIZE)
+	{
+		DirectoryEntry entry{
+			{ (int)(std::int32_t)readU32(p), (int)(std::int32_t)readU32(p + 4) },
+			readU32(p + 8),
+			readU32(p + 12)
+		};
+		// blocks are after the tables
+		if (entry.offset < tablesSize || (std::size_t)entry.offset + entry.size > size)
+			return fail("chunk out of file");
+		if (!coords.insert((std::uint64_t)(std::uint32_t)entry.coords.x << 32 | (std::uint32_t)entry.coords.y).second)
+			return fail("duplicate chunk");
+		m_directory.push_back(entry);
+	}
+
+	// Entity table
+	m_entities.reserve(entityCount);
+	bool hasPlayer = false;
+	for (std::uint32_t i = 0; i < entityCount; ++i, p += ENTITY_SIZE)
+	{
+		if (p[0] > (std::uint8_t)LevelEntity::Type::Enemy)
+			return fail("unknown entity type");
+		if (p[0] == (std::uint8_t)LevelEntity::Type::Player)
+		{
+			if (hasPlayer)
+				return fail("more than one player");
+			hasPlayer = true;
+		}
+		m_entities.push_back({ (LevelEntity::Type)p[0], readF32(p + 1), readF32(p + 5) });
+	}
+
+	return true;
+}
+
+void LevelFile::close()
+{
+	m_file.close();
+	m_filename.clear();
+	m_chunkSize = 0;
+	m_palette.clear();
+	m_directory.clear();
+	m_entities.clear();
+}
+
+bool LevelFile::decodeChunk(std::size_t index, std::vector<std::uint8_t>& cells) const
+{
+	const DirectoryEntry& entry = m_directory[index];
+	const unsigned char* p = m_file.data() + entry.offset;
+	const unsigned char* end = p + entry.size;
+
+	const std::size_t cellCount = (std::size_t)m_chunkSize * m_chunkSize;
+	cells.clear();
+	cells.reserve(cellCount);
+
+	// stops as soon as the chunk overflows: a corrupted block can't make it grow past its run lengths
+	for (; p + 1 < end && cells.size() <= cellCount; p += 2)
+		cells.insert(cells.end(), p[0], p[1]);
+
+	if (p != end || cells.size() != cellCount)
+	{
+		std::cerr << "LevelFile: corrupted chunk (" << entry.coords.x << ";" << entry.coords.y << ")" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool LevelFile::write(const std::string& filename, int chunkSize, const std::string& palette,
+	const std::vector<LevelChunk>& chunks, const std::vector<LevelEntity>& entities)
+{
+	// Compress blocks first: their offsets go in the directory
+	std::vector<unsigned char> blocks;
+	std::vector<std::uint32_t> blockSizes;
+	blockSizes.reserve(chunks.size());
+
+	for (const LevelChunk& chunk : chunks)
+	{
+		const std::size_t before = blocks.size();
+		for (std::size_t i = 0; i < chunk.cells.size();)
+		{
+			std::size_t run = 1;
+			while (run < 255 && i + run < chunk.cells.size() && chunk.cells[i + run] == chunk.cells[i])
+				++run;
+			blocks.push_back((unsigned char)run);
+			blocks.push_back(chunk.cells[i]);
+			i += run;
+		}
+		blockSizes.push_back((std::uint32_t)(blocks.size() - before));
+	}
+
+	std::vector<unsigned char> out;
+	out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+	writeU16(out, VERSION);
+	writeU16(out, (std::uint16_t)chunkSize);
+	writeU32(out, (std::uint32_t)palette.size());
+	writeU32(out, (std::uint32_t)chunks.size());
+	writeU32(out, (std::uint32_t)entities.size());
+
+	out.insert(out.end(), palette.begin(), palette.end());
+
+	std::uint32_t offset = (std::uint32_t)(out.size()
+		+ chunks.size() * DIRECTORY_ENTRY_SIZE
+		+ entities.size() * ENTITY_SIZE);
+	for (std::size_t i = 0; i < chunks.size(); ++i)
+	{
+		writeU32(out, (std::uint32_t)chunks[i].coords.x);
+		writeU32(out, (std::uint32_t)chunks[i].coords.y);
+		writeU32(out, offset);
+		writeU32(out, blockSizes[i]);
+		offset += blockSizes[i];
+	}
+
+	for (const LevelEntity& entity : entities)
+	{
+		out.push_back((unsigned char)entity.type);
+		writeF32(out, entity.x);
+		writeF32(out, entity.y);
+	}
+
+	out.insert(out.end(), blocks.begin(), blocks.end());
+
+	std::ofstream stream(filename, std::ios::binary);
+	if (!stream)
+	{
+		std::cerr << "LevelFile: couldn't create " << filename << std::endl;
+		return false;
+	}
+	stream.write(reinterpret_cast<const char*>(out.data()), (std::streamsize)out.size());
+	return (bool)stream;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Utility/MappedFile.hpp"
+
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Entity spawn point, as stored in level files **/
+struct LevelEntity
+{
+	enum class Type : std::uint8_t
+	{
+		Player = 0,
+		Enemy
+	};
+
+	Type type;
+	float x, y;
+};
+
+/** One chunk of tiles, cells are palette slots in row-major order (chunkSize * chunkSize) **/
+struct LevelChunk
+{
+	sf::Vector2i coords;
+	std::vector<std::uint8_t> cells;
+};
+
+/** Binary level container (level.bin), little-endian:
+ *
+ *  header     "WLVL", u16 version, u16 chunkSize, u32 paletteSize, u32 chunkCount, u32 entityCount
+ *  palette    paletteSize chars: in-file tile index of each palette slot
+ *  directory  chunkCount * { i32 chunkX, i32 chunkY, u32 offset, u32 size }
+ *  entities   entityCount * { u8 type, f32 x, f32 y }
+ *  blocks     RLE compressed chunks: { u8 runLength, u8 paletteSlot } pairs
+ *
+ *  The file is memory mapped: opening only checks the header and the directory, chunks are decoded on demand **/
+class LevelFile
+{
+public:
+	static constexpr std::uint16_t VERSION = 1;
+
+	bool open(const std::string& filename);
+	void close();
+	[[nodiscard]] bool isOpen() const { return m_file.isOpen(); }
+	[[nodiscard]] const std::string& getFilename() const { return m_filename; }
+
+	[[nodiscard]] int getChunkSize() const { return m_chunkSize; }
+	[[nodiscard]] const std::string& getPalette() const { return m_palette; }
+	[[nodiscard]] const std::vector<LevelEntity>& getEntities() const { return m_entities; }
+
+	[[nodiscard]] std::size_t getChunkCount() const { return m_directory.size(); }
+	[[nodiscard]] sf::Vector2i getChunkCoords(std::size_t index) const { return m_directory[index].coords; }
+	bool decodeChunk(std::size_t index, std::vector<std::uint8_t>& cells) const;
+
+	static bool write(const std::string& filename, int chunkSize, const std::string& palette,
+		const std::vector<LevelChunk>& chunks, const std::vector<LevelEntity>& entities);
+
+private:
+	struct DirectoryEntry
+	{
+		sf::Vector2i coords;
+		std::uint32_t offset;
+		std::uint32_t size;
+	};
+
+	MappedFile m_file;
+	std::string m_filename;
+
+	int m_chunkSize = 0;
+	std::string m_palette;
+	std::vector<DirectoryEntry> m_directory;
+	std::vector<LevelEntity> m_entities;	// small: copied out of the mapping on open
+};
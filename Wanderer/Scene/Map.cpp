@@ -1,380 +1,720 @@
 #include "Scene/Map.hpp"
+#include "Scene/ChunkStreamer.hpp"
+#include "Scene/RenderStats.hpp"
 #include "Constants.hpp"
+#include "Utility/Logger.hpp"
+#include "Utility/Profiler.hpp"
 
 #include <algorithm>
 #include <iostream>
-#include <cassert>
 #include <cmath>
+#include <cstring>
+#include <fstream>
 
 [[maybe_unused]] void Map::printGrid()
 {
-	for (int y = 0; y < GRID_HEIGHT; ++y)
+	const sf::IntRect bounds = getBounds();
+	for (int y = bounds.top; y < bounds.top + bounds.height; ++y)
 	{
-		for (int x = 0; x < GRID_WIDTH; ++x)
-			std::cout << (size_t)m_grid[x][y] << " ";
+		for (int x = bounds.left; x < bounds.left + bounds.width; ++x)
+			std::cout << (size_t)getTile(x, y) << " ";
 		std::cout << std::endl;
 	}
 }
 
-bool Map::load(const std::string& filename)
+Map::Map(TilesManager& mt)
+	: m_tilesMgr(mt)
 {
-	// reset
-	GRID_WIDTH = GRID_HEIGHT = 0;
-	m_grid.clear();
-	m_vertices.clear();
+}
+
+Map::~Map() = default;	// ChunkStreamer is complete here
 
+void Map::clear()
+{
+	m_streamer.reset();	// joins the streaming thread
+	m_chunks.clear();
+	m_chunkBuffers.clear();
+	m_editedChunks.clear();
+	m_bounds = sf::IntRect();
+	m_boundsDirty = false;
+	m_levelFilename.clear();
+}
+
+bool Map::load(const std::string& filename)
+{
+	clear();
 	m_levelFilename = filename;
 
-	std::ifstream file(filename);
+	// Whole file at once, then scanned in place
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
 	if (!file)
 	{
 		std::cerr << "Map load: can't open " << filename << std::endl;
 		return false;
 	}
-	
-	std::string line;
 
-	// used in nested loops
-	std::size_t i;
-	int currentRowIndex = -1;
+	const std::streamoff size = file.tellg();
+	if (size < 0)	// not a regular file
+	{
+		std::cerr << "Map load: can't get the size of " << filename << std::endl;
+		return false;
+	}
+
+	std::string text((std::size_t)size, '\0');
+	file.seekg(0);
+	if (!file.read(&text[0], (std::streamsize)text.size()))
+	{
+		std::cerr << "Map load: can't read " << filename << std::endl;
+		return false;
+	}
 
-	// checks for file corruption. -1 if not initalized. otherwise value shouldn't change below
-	int lineSize = -1;
+	// One TileId per cell, row-major, the file's top-left tile is the world origin
+	std::vector<TileId> grid;
+	int width = -1;	// set by the first row, the others must match
+	int height = 0;
 
-	while (std::getline(file, line))
+	const char* cursor = text.data();
+	const char* const end = cursor + text.size();
+	while (cursor < end)
 	{
-		++currentRowIndex;  // counts number of rows
+		const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', (std::size_t)(end - cursor)));
+		if (!lineEnd)
+			lineEnd = end;
 
-		for (i = 0; i < line.size(); ++i)   // trim whitespaces
+		const std::size_t rowStart = grid.size();
+		for (const char* c = cursor; c < lineEnd; ++c)
 		{
-			if (line[i] == ' ')
-				line.erase(i, 1);
-		}
+			if (*c == ' ' || *c == '\r')	// separators
+				continue;
 
-		if (lineSize == -1) // set up GRID_WIDTH automatically from file
-		{
-			lineSize = (int)line.size(); // new size, after trimming whitespaces
-			GRID_WIDTH = lineSize;
-			m_grid.resize(GRID_WIDTH);
+			if (!m_tilesMgr.isKnownIndex(*c))
+			{
+				std::cerr << filename << ":" << height + 1 << ":" << (c - cursor) + 1
+					<< ": unknown tile index '" << *c << "', using the default tile" << std::endl;
+				grid.push_back(m_tilesMgr.getDefaultTile());
+			}
+			else
+				grid.push_back(m_tilesMgr.getTileFromIndex(*c));
 		}
+		cursor = lineEnd + 1;
 
-		// runtime assertion fails if level file is not properly set up
-		assert((unsigned)lineSize == line.size());
+		const int rowWidth = (int)(grid.size() - rowStart);
+		if (rowWidth == 0)	// blank line, e.g. trailing newline
+			continue;
 
-		// reads file data and sets up m_grid procedurally
-		for (i = 0; i < line.size(); ++i)
+		if (width == -1)
 		{
-			m_grid[i].reserve(currentRowIndex);
-			m_grid[i].emplace_back(m_tilesMgr.getTileFromIndex(line[i]));
+			width = rowWidth;
+			grid.reserve(text.size() / 2 + 1);	// "c " per cell: upper bound
 		}
+		else if (rowWidth != width)
+		{
+			std::cerr << filename << ":" << height + 1 << ": row has " << rowWidth
+				<< " tiles, expected " << width << " like the first row" << std::endl;
+			clear();
+			return false;
+		}
+		++height;
 	}
 
-	// At this state, currentRowIndex represents the maximum index, so the vertical size-1 of the grid
-	GRID_HEIGHT = currentRowIndex + 1;  // set up GRID_HEIGHT automatically from file
+	// Chunks are filled directly: no per-cell hashing
+	const TileId defaultTile = m_tilesMgr.getDefaultTile();
+	for (int cy = 0; cy * CHUNK_SIZEi < height; ++cy)
+	{
+		for (int cx = 0; cx * CHUNK_SIZEi < width; ++cx)
+		{
+			TileChunk chunk(defaultTile);
+			const int w = std::min(CHUNK_SIZEi, width - cx * CHUNK_SIZEi);
+			const int h = std::min(CHUNK_SIZEi, height - cy * CHUNK_SIZEi);
+			for (int j = 0; j < h; ++j)
+			{
+				const TileId* row = &grid[(std::size_t)(cy * CHUNK_SIZEi + j) * (std::size_t)width + (std::size_t)(cx * CHUNK_SIZEi)];
+				std::copy_n(row, w, &chunk.at(0, j));
+			}
+
+			indexChunk(chunk);
+			if (chunk.occupied != 0)
+				m_chunks.emplace(makeChunkKey(cx, cy), std::move(chunk));
+		}
+	}
+	m_boundsDirty = true;
 
 	m_virtualGround = 200;
 
-	std::cout << GRID_WIDTH << "x" << GRID_HEIGHT << std::endl;
+	LOG(Info, "%dx%d (%zu chunks)", std::max(width, 0), height, m_chunks.size());
 
-	// creates an optimized (smaller than m_grid) vertex array
+	// creates an optimized (smaller than the grid) vertex array
 	regenerateVertices();
 
-	std::cout << "grid size: " << GRID_WIDTH * GRID_HEIGHT << std::endl;
-	// std::cout << "vertex array size: " << m_vertices.size() << std::endl;
-
-
 	return true;	// level loaded successfully
 }
 
-const std::string& Map::getLevelFilename() const
+bool Map::save(const std::string& filename) const
 {
-	return m_levelFilename;
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "Map save: can't create " << filename << std::endl;
+		return false;
+	}
+
+	// Rows are built in a buffer then written at once: "c c c ", rows separated by '\n'
+	const sf::IntRect bounds = getBounds();
+	std::string row;
+	row.reserve((std::size_t)bounds.width * 2 + 1);
+
+	const char defaultIndex = m_tilesMgr.getTileIndexFromId(m_tilesMgr.getDefaultTile());
+	const int right = bounds.left + bounds.width;
+	for (int y = bounds.top; y < bounds.top + bounds.height; ++y)
+	{
+		row.clear();
+
+		// one chunk lookup per chunk crossed by the row, not per tile
+		for (int x = bounds.left; x < right;)
+		{
+			const int cx = tileToChunk(x);
+			const int chunkEnd = std::min((cx + 1) * CHUNK_SIZEi, right);
+			auto it = m_chunks.find(makeChunkKey(cx, tileToChunk(y)));
+			for (; x < chunkEnd; ++x)
+			{
+				row += it != m_chunks.end() ? m_tilesMgr.getTileIndexFromId(it->second.at(tileToLocal(x), tileToLocal(y))) : defaultIndex;
+				row += ' ';
+			}
+		}
+
+		if (y + 1 < bounds.top + bounds.height)
+			row += '\n';
+		file.write(row.data(), (std::streamsize)row.size());
+	}
+
+	if (!file)
+	{
+		std::cerr << "Map save: can't write " << filename << std::endl;
+		return false;
+	}
+	return true;
 }
 
-void Map::setTile(int x, int y, TileId newTile, bool* newColLeft, bool* newRowTop)
+bool Map::load(const LevelFile& levelFile)
 {
-	if (x >= 0 && x < GRID_WIDTH && y >= 0 && y < GRID_HEIGHT) // no increase, maybe decrease
-	{
-		// testing property first for optimization
-		if (m_grid[x][y] == newTile)   // same tile
-			return;
+	clear();
+	m_levelFilename = levelFile.getFilename();
+
+	const std::vector<TileId> slotToTile = makeSlotTable(levelFile);
+	const int chunkSize = levelFile.getChunkSize();	// may differ from CHUNK_SIZEi
+	std::vector<std::uint8_t> cells;
 
-		m_grid[x][y] = newTile;
+	for (std::size_t c = 0; c < levelFile.getChunkCount(); ++c)
+	{
+		if (!levelFile.decodeChunk(c, cells))
+			continue;
 
-		if (getTileProperty(x, y) == Tile::Property::Void)  // try to reduce on deletion
+		const sf::Vector2i origin = levelFile.getChunkCoords(c) * chunkSize;
+		for (int j = 0; j < chunkSize; ++j)
 		{
-			// ----- Becareful functions: move entities and cam -----
-			*newColLeft = removeEmptyColsLeft();
-			*newRowTop = removeEmptyRowsTop();
-			// ------------------------------------------------------
+			for (int i = 0; i < chunkSize; ++i)
+				storeTile(origin.x + i, origin.y + j, slotToTile[cells[j * chunkSize + i]]);
+		}
+	}
 
+	m_virtualGround = 200;
 
-			removeEmptyColsRight();
-			removeEmptyRowsBottom();
-		}
+	LOG(Info, "binary level: %zu chunks", levelFile.getChunkCount());
 
-		regenerateVertices();
+	regenerateVertices();
+	return true;	// level loaded successfully
+}
 
-		// std::cout << "vertex array size: " << m_vertices.size() << std::endl;
+std::vector<TileId> Map::makeSlotTable(const LevelFile& levelFile) const
+{
+	// Palette slots to current TileIds
+	const std::string& palette = levelFile.getPalette();
+	std::vector<TileId> slotToTile(256, m_tilesMgr.getDefaultTile());
+	for (std::size_t slot = 0; slot < palette.size(); ++slot)
+	{
+		if (m_tilesMgr.isKnownIndex(palette[slot]))
+			slotToTile[slot] = m_tilesMgr.getTileFromIndex(palette[slot]);
+		else
+			std::cerr << "Map load: unknown tile index '" << palette[slot] << "' in " << levelFile.getFilename() << std::endl;
 	}
-	else if (newTile != m_tilesMgr.getDefaultTile())  // modify grid dimensions
+	return slotToTile;
+}
+
+bool Map::stream(std::unique_ptr<LevelFile> levelFile)
+{
+	if (levelFile->getChunkSize() != CHUNK_SIZEi)
 	{
-		// Adding bottom-right
-		if (x >= GRID_WIDTH && y >= GRID_HEIGHT)
-		{
-			std::cout << "adding bottom right" << std::endl;
+		std::cerr << "Map stream: chunk size mismatch, loading " << levelFile->getFilename() << " at once" << std::endl;
+		return load(*levelFile);
+	}
 
-			addColsRight(x - GRID_WIDTH + 1);
-			addRowsBottom(y - GRID_HEIGHT + 1);
+	clear();
+	m_levelFilename = levelFile->getFilename();
 
-			setTile(0, 0, newTile);
-		}
+	const std::vector<TileId> slotToTile = makeSlotTable(*levelFile);
+	m_streamer = std::make_unique<ChunkStreamer>(std::move(levelFile), *this, slotToTile, m_tilesMgr.getDefaultTile());
 
-		// Adding bottom only
-		else if (x >= 0 && x < GRID_WIDTH && y >= GRID_HEIGHT)
-		{
-			std::cout << "adding bottom only" << std::endl;
+	// Approximation until every chunk has been seen: whole chunks
+	m_bounds = m_streamer->getTileBounds();
+	m_streamingFrame = 0;
+	m_virtualGround = 200;
 
-			// need to add more rows
-			addRowsBottom(y - GRID_HEIGHT + 1);
+	LOG(Info, "streaming level: %zu chunks", m_streamer->getDirectory().size());
 
-			setTile(x, y, newTile);
-		}
+	return true;
+}
 
-		// Adding right only
-		else if (x >= GRID_WIDTH && y >= 0 && y < GRID_HEIGHT)  // increase GRID_WIDTH (adding right)
-		{
-			std::cout << "adding right only" << std::endl;
+void Map::updateStreaming(const sf::Vector2f& center)
+{
+	if (!m_streamer)
+		return;
 
-			// need to add more cols
-			addColsRight(x - GRID_WIDTH + 1);
+	++m_streamingFrame;
 
-			setTile(x, y, newTile);
-		}
+	// Integrate chunks decoded and meshed by the streaming thread
+	m_streamer->collect(m_streamedIn);
+	for (auto& [key, chunk] : m_streamedIn)
+	{
+		// already there if it was edited or loaded synchronously meanwhile
+		auto inserted = m_chunks.try_emplace(key, std::move(chunk));
+		if (inserted.second)
+			inserted.first->second.lastUsed = m_streamingFrame;
+	}
+	m_streamedIn.clear();
 
-		// Adding top-left
-		else if (x < 0 && y < 0)
+	// Request what is in range, mark resident chunks as used
+	const int radius = m_streamer->getRadius();
+	m_streamingCenter = {
+		tileToChunk((int)std::floor(center.x / TILE_SIZEf)),
+		tileToChunk((int)std::floor(center.y / TILE_SIZEf))
+	};
+
+	for (int cy = m_streamingCenter.y - radius; cy <= m_streamingCenter.y + radius; ++cy)
+	{
+		for (int cx = m_streamingCenter.x - radius; cx <= m_streamingCenter.x + radius; ++cx)
 		{
-			std::cout << "adding top-left" << std::endl;
+			const ChunkKey key = makeChunkKey(cx, cy);
+			auto it = m_chunks.find(key);
+			if (it != m_chunks.end())
+				it->second.lastUsed = m_streamingFrame;
+			else if (m_streamer->contains(key))
+				m_streamer->request(key);
+		}
+	}
 
-			*newRowTop = true;
-			*newColLeft = true;
+	// Evict least recently used chunks once over capacity, edited ones are kept
+	const std::size_t capacity = m_streamer->getCapacity();
+	if (m_chunks.size() <= capacity)
+		return;
 
-			addColsLeft(-x);
-			addRowsTop(-y);
+	auto& candidates = m_evictionCandidates;
+	candidates.clear();
+	for (const auto& [key, chunk] : m_chunks)
+	{
+		if (!chunk.pinned && chunk.lastUsed != m_streamingFrame)
+			candidates.emplace_back(chunk.lastUsed, key);
+	}
 
-			setTile(0, 0, newTile);
-		}
+	const std::size_t excess = std::min(m_chunks.size() - capacity, candidates.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + (std::ptrdiff_t)excess, candidates.end());
+	for (std::size_t i = 0; i < excess; ++i)
+		eraseChunk(m_chunks.find(candidates[i].second));
+}
 
-		// Adding top only
-		else if (x >= 0 && x < GRID_WIDTH && y < 0)
-		{
-			std::cout << "adding top only" << std::endl;
+void Map::eraseChunk(std::unordered_map<ChunkKey, TileChunk>::iterator it)
+{
+	m_chunkBuffers.erase(it->first);
+	m_chunks.erase(it);
+}
 
-			*newRowTop = true;
+void Map::streamInAround(const sf::Vector2f& center)
+{
+	if (!m_streamer)
+		return;
 
-			addRowsTop(-y);
+	const int radius = m_streamer->getRadius();
+	m_streamingCenter = {
+		tileToChunk((int)std::floor(center.x / TILE_SIZEf)),
+		tileToChunk((int)std::floor(center.y / TILE_SIZEf))
+	};
 
-			setTile(x, 0, newTile);
+	for (int cy = m_streamingCenter.y - radius; cy <= m_streamingCenter.y + radius; ++cy)
+	{
+		for (int cx = m_streamingCenter.x - radius; cx <= m_streamingCenter.x + radius; ++cx)
+		{
+			if (TileChunk* chunk = streamInNow(makeChunkKey(cx, cy)))
+				chunk->lastUsed = m_streamingFrame;
 		}
+	}
+	m_boundsDirty = true;
+}
 
-		// Adding left only
-		else if (x < 0 && y >= 0 && y < GRID_HEIGHT)
-		{
-			std::cout << "adding left only" << std::endl;
+void Map::stopStreaming()
+{
+	if (!m_streamer)
+		return;
 
-			*newColLeft = true;
+	for (const auto& entry : m_streamer->getDirectory())
+		streamInNow(entry.first);
 
-			addColsLeft(-x);
+	m_streamer.reset();
+	m_boundsDirty = true;
+}
 
-			setTile(0, y, newTile);
-		}
+TileChunk* Map::streamInNow(ChunkKey key)
+{
+	auto it = m_chunks.find(key);
+	if (it != m_chunks.end())
+		return &it->second;
 
-		// Adding top-right
-		else if (x >= GRID_WIDTH && y < 0)
-		{
-			std::cout << "Adding top right" << std::endl;
+	TileChunk chunk(m_tilesMgr.getDefaultTile());
+	if (!m_streamer || !m_streamer->loadNow(key, chunk))
+		return nullptr;
 
-			*newRowTop = true;
+	it = m_chunks.emplace(key, std::move(chunk)).first;
+	it->second.lastUsed = m_streamingFrame;
+	return &it->second;
+}
 
-			addRowsTop(-y);
-			addColsRight(x - GRID_WIDTH + 1);
+void Map::setStreamingRadius(int radius)
+{
+	if (m_streamer)
+		m_streamer->setRadius(std::max(radius, 1));
+}
 
-			setTile(x, 0, newTile);
-		}
+int Map::getStreamingRadius() const
+{
+	return m_streamer ? m_streamer->getRadius() : 0;
+}
 
-		// Adding bottom-left
-		else if (x < 0 && y >= GRID_HEIGHT)
-		{
-			std::cout << "Adding bottom-left" << std::endl;
+bool Map::isActiveAt(const sf::Vector2f& position) const
+{
+	if (!m_streamer)
+		return true;
 
-			*newColLeft = true;
+	// In range and not waiting for its chunk
+	const int cx = tileToChunk((int)std::floor(position.x / TILE_SIZEf));
+	const int cy = tileToChunk((int)std::floor(position.y / TILE_SIZEf));
+	const int radius = m_streamer->getRadius();
+	if (std::abs(cx - m_streamingCenter.x) > radius || std::abs(cy - m_streamingCenter.y) > radius)
+		return false;
 
-			addColsLeft(-x);
-			addRowsBottom(y - GRID_HEIGHT + 1);
+	const ChunkKey key = makeChunkKey(cx, cy);
+	return m_chunks.count(key) != 0 || !m_streamer->contains(key);
+}
 
-			setTile(0, y, newTile);
-		}
+std::vector<LevelChunk> Map::exportChunks() const
+{
+	std::vector<LevelChunk> chunks;
+	chunks.reserve(m_chunks.size());
 
-		else
-			std::cerr << "unhandled insertion: (x=" << x << "; y=" << y << ")" << std::endl;
-	}
+	for (const auto& [key, chunk] : m_chunks)
+		chunks.push_back({ chunkFromKey(key), std::vector<std::uint8_t>(chunk.tiles.begin(), chunk.tiles.end()) });
 
-	else
-		std::cerr << "setTile: undef ref at " << x << ";" << y << std::endl;
+	return chunks;
 }
 
-void Map::addRowsBottom(std::size_t n)
+const std::string& Map::getLevelFilename() const
 {
-	if (n == 0)
-		return;
+	return m_levelFilename;
+}
 
-	GRID_HEIGHT += n;
-	for (auto& col : m_grid)
+void Map::setTile(int x, int y, TileId newTile)
+{
+	if (m_editDepth > 0)	// quads rebuilt once in endEdit()
 	{
-		col.reserve(GRID_HEIGHT);
-		col.insert(col.end(), n, m_tilesMgr.getDefaultTile());
+		if (storeTile(x, y, newTile))
+			m_editedChunks.insert(makeChunkKey(tileToChunk(x), tileToChunk(y)));
 	}
+	else if (TileChunk* chunk = storeTile(x, y, newTile))
+		updateQuad(*chunk, x, y);
 }
 
-void Map::addRowsTop(std::size_t number)
+void Map::beginEdit()
 {
-	for (auto& col : m_grid)
-		col.insert(col.begin(), number, m_tilesMgr.getDefaultTile());
-	GRID_HEIGHT += number;
+	++m_editDepth;
 }
 
-void Map::addColsRight(std::size_t n)
+void Map::endEdit()
 {
-	if (n == 0)
+	if (m_editDepth == 0 || --m_editDepth > 0)
 		return;
 
-	GRID_WIDTH += n;
-	m_grid.reserve(GRID_WIDTH);
-	m_grid.insert(m_grid.end(), n, std::vector<TileId>(GRID_HEIGHT, m_tilesMgr.getDefaultTile()));
+	for (ChunkKey key : m_editedChunks)
+	{
+		auto it = m_chunks.find(key);
+		if (it != m_chunks.end())	// not dropped by the edit
+			meshChunk(it->second, chunkFromKey(key) * CHUNK_SIZEi);
+	}
+	m_editedChunks.clear();
 }
 
-void Map::addColsLeft(std::size_t number)
+void Map::floodFill(const sf::Vector2i& start, TileId tile)
 {
-	m_grid.insert(m_grid.begin(), number, std::vector<TileId>(GRID_HEIGHT, m_tilesMgr.getDefaultTile()));
-	GRID_WIDTH += number;
-}
+	stopStreaming();	// reads any cell of the area: non resident chunks would look empty
 
-void Map::removeEmptyColsRight()
-{
-	auto countVoid = [&]() -> int
-	{
-		if (!m_grid.empty())
-			return std::count(m_grid.back().begin(), m_grid.back().end(), m_tilesMgr.getDefaultTile());
-		return -1;
-	};
+	// The outside is unbounded: the fill stops one tile around the map
+	const sf::IntRect bounds = getBounds();
+	const sf::IntRect area(bounds.left - 1, bounds.top - 1, bounds.width + 2, bounds.height + 2);
+	const TileId target = getTile(start.x, start.y);
+	if (target == tile || !area.contains(start))
+		return;
 
-	int count = countVoid();
-	while (count == GRID_HEIGHT)
+	// Scanline fill: spans are filled left to right, the rows above and below are queued
+	std::vector<sf::Vector2i> stack{ start };
+	beginEdit();
+	while (!stack.empty())
 	{
-		// delete col
-		m_grid.pop_back();
-		--GRID_WIDTH;
+		sf::Vector2i p = stack.back();
+		stack.pop_back();
+		if (getTile(p.x, p.y) != target)
+			continue;
+
+		while (p.x > area.left && getTile(p.x - 1, p.y) == target)
+			--p.x;
+
+		bool spanAbove = false;
+		bool spanBelow = false;
+		for (; p.x < area.left + area.width && getTile(p.x, p.y) == target; ++p.x)
+		{
+			setTile(p.x, p.y, tile);
 
-		count = countVoid();
+			const bool above = p.y > area.top && getTile(p.x, p.y - 1) == target;
+			if (above && !spanAbove)
+				stack.emplace_back(p.x, p.y - 1);
+			spanAbove = above;
+
+			const bool below = p.y + 1 < area.top + area.height && getTile(p.x, p.y + 1) == target;
+			if (below && !spanBelow)
+				stack.emplace_back(p.x, p.y + 1);
+			spanBelow = below;
+		}
 	}
+	endEdit();
 }
 
-bool Map::removeEmptyColsLeft()
+TileChunk* Map::storeTile(int x, int y, TileId newTile)
 {
-	auto countVoid = [&]() -> int
+	const TileId defaultTile = m_tilesMgr.getDefaultTile();
+	const ChunkKey key = makeChunkKey(tileToChunk(x), tileToChunk(y));
+
+	// Streaming: edit the file's chunk, not a blank one
+	if (m_streamer && m_streamer->contains(key))
+		streamInNow(key);
+
+	auto it = m_chunks.find(key);
+	if (it == m_chunks.end())
 	{
-		if (!m_grid.empty())
-			return std::count(m_grid.front().begin(), m_grid.front().end(), m_tilesMgr.getDefaultTile());
-		return -1;
-	};
+		if (newTile == defaultTile)	// erasing where nothing is stored
+			return nullptr;
+		it = m_chunks.try_emplace(key, defaultTile).first;
+		it->second.planes[(int)m_tilesMgr.getTilePropertyFromId(defaultTile)].fill((ChunkRow)~ChunkRow(0));
+	}
+
+	TileChunk& chunk = it->second;
+	TileId& cell = chunk.at(tileToLocal(x), tileToLocal(y));
+	if (cell == newTile)   // same tile
+		return nullptr;
+
+	chunk.pinned = m_streamer != nullptr;	// evicting it would lose the edit
 
-	int previousGridWidth = GRID_WIDTH;	// to check if one dim is modified
+	const TileId previousTile = cell;
+	cell = newTile;
 
-	int count = countVoid();
-	while (count == GRID_HEIGHT)
+	// Update collision bitplanes
+	const int localX = tileToLocal(x);
+	const int localY = tileToLocal(y);
+	chunk.planes[(int)m_tilesMgr.getTilePropertyFromId(previousTile)][localY] &= (ChunkRow)~(1u << localX);
+	chunk.planes[(int)m_tilesMgr.getTilePropertyFromId(newTile)][localY]      |= (ChunkRow)(1u << localX);
+
+	if (previousTile == defaultTile)	// placing: bounds can only grow
+	{
+		++chunk.occupied;
+
+		if (m_bounds.width == 0)
+			m_bounds = sf::IntRect(x, y, 1, 1);
+		else
+		{
+			const int right  = std::max(m_bounds.left + m_bounds.width,  x + 1);
+			const int bottom = std::max(m_bounds.top  + m_bounds.height, y + 1);
+			m_bounds.left = std::min(m_bounds.left, x);
+			m_bounds.top  = std::min(m_bounds.top,  y);
+			m_bounds.width  = right  - m_bounds.left;
+			m_bounds.height = bottom - m_bounds.top;
+		}
+	}
+	else if (newTile == defaultTile)	// removing
 	{
-		// delete col
-		m_grid.erase(m_grid.begin());
-		--GRID_WIDTH;
+		// Removing a tile on the edge may shrink the bounds: recomputed lazily in getBounds()
+		if (x == m_bounds.left || x == m_bounds.left + m_bounds.width - 1 ||
+			y == m_bounds.top  || y == m_bounds.top  + m_bounds.height - 1)
+			m_boundsDirty = true;
 
-		count = countVoid();
+		// its quads go with it. Streaming: kept empty, or the file's version would come back
+		if (--chunk.occupied == 0 && !m_streamer)
+		{
+			eraseChunk(it);
+			return nullptr;
+		}
 	}
 
-	return GRID_WIDTH != previousGridWidth;
+	return &chunk;
 }
 
-void Map::removeEmptyRowsBottom()
+void Map::updateQuad(TileChunk& chunk, int x, int y) const
 {
-	auto countVoid = [&]() -> int
+	const int cell = tileToLocal(y) * CHUNK_SIZEi + tileToLocal(x);
+	const TileId tile = chunk.tiles[cell];
+	const int quad = chunk.quads[cell];
+	const bool drawn = m_tilesMgr.getTilePropertyFromId(tile) != Tile::Property::Void;
+
+	if (quad != TileChunk::NO_QUAD && drawn)	// patch
+		writeQuad(chunk, quad, x, y, tile);
+	else if (quad != TileChunk::NO_QUAD)
 	{
-		int c = 0;
-		for (auto& col : m_grid)
-		{
-			if (col.back() == m_tilesMgr.getDefaultTile())
-				++c;
-		}
-		return c;
-	};
-
-	int count = countVoid();
-	while (count == GRID_WIDTH)
+		chunk.quads[cell] = TileChunk::NO_QUAD;
+		removeQuad(chunk, quad);
+	}
+	else if (drawn)	// append
 	{
-		// delete row
-		for (auto& col : m_grid)
-			col.pop_back();
-		--GRID_HEIGHT;
+		const auto newQuad = (std::int16_t)chunk.quadCells.size();
+		chunk.vertices.resize(chunk.vertices.size() + 4);
+		chunk.quadCells.push_back((std::uint8_t)cell);
+		chunk.quads[cell] = newQuad;
+		writeQuad(chunk, newQuad, x, y, tile);
+	}
+	else
+		return;
 
-		count = countVoid();
+	chunk.bufferDirty = true;
+}
+
+void Map::writeQuad(TileChunk& chunk, int quad, int x, int y, TileId tile) const
+{
+	// set position & texture coords
+	const auto texCoords = m_tilesMgr.getTileTexCoordsFromId(tile);   // for read-ability
+	sf::Vertex* v = &chunk.vertices[(std::size_t)quad * 4];
+
+	v[0] = sf::Vertex(
+		sf::Vector2f(x * TILE_SIZEi, y * TILE_SIZEi),
+		texCoords);
+	v[1] = sf::Vertex(
+		sf::Vector2f((x + 1) * TILE_SIZEi, y * TILE_SIZEi),
+		sf::Vector2f(texCoords.x + TILE_SIZEi, texCoords.y));
+	v[2] = sf::Vertex(
+		sf::Vector2f((x + 1) * TILE_SIZEi, (y + 1) * TILE_SIZEi),
+		sf::Vector2f(texCoords.x + TILE_SIZEi, texCoords.y + TILE_SIZEi));
+	v[3] = sf::Vertex(
+		sf::Vector2f(x * TILE_SIZEi, (y + 1) * TILE_SIZEi),
+		sf::Vector2f(texCoords.x, texCoords.y + TILE_SIZEi));
+}
+
+void Map::removeQuad(TileChunk& chunk, int quad)
+{
+	const int last = (int)chunk.quadCells.size() - 1;
+	if (quad != last)
+	{
+		// move the last quad in the hole
+		std::copy_n(chunk.vertices.begin() + last * 4, 4, chunk.vertices.begin() + quad * 4);
+		chunk.quadCells[quad] = chunk.quadCells[last];
+		chunk.quads[chunk.quadCells[quad]] = (std::int16_t)quad;
 	}
+
+	chunk.vertices.resize(chunk.vertices.size() - 4);
+	chunk.quadCells.pop_back();
 }
 
-bool Map::removeEmptyRowsTop()
+sf::IntRect Map::getBounds() const
 {
-	auto countVoid = [&]() -> int
+	if (m_boundsDirty)
+		recomputeBounds();
+	return m_bounds;
+}
+
+void Map::recomputeBounds() const
+{
+	const TileId defaultTile = m_tilesMgr.getDefaultTile();
+	bool empty = true;
+	int minX = 0, minY = 0, maxX = 0, maxY = 0;
+
+	for (const auto& [key, chunk] : m_chunks)
 	{
-		int c = 0;
-		for (auto& col : m_grid)
+		const sf::Vector2i origin = chunkFromKey(key) * CHUNK_SIZEi;
+
+		// A chunk lying inside the current bounds can't extend them
+		if (!empty &&
+			origin.x >= minX && origin.x + CHUNK_SIZEi - 1 <= maxX &&
+			origin.y >= minY && origin.y + CHUNK_SIZEi - 1 <= maxY)
+			continue;
+
+		for (int j = 0; j < CHUNK_SIZEi; ++j)
 		{
-			if (col.front() == m_tilesMgr.getDefaultTile())
-				++c;
+			for (int i = 0; i < CHUNK_SIZEi; ++i)
+			{
+				if (chunk.at(i, j) == defaultTile)
+					continue;
+
+				const int x = origin.x + i;
+				const int y = origin.y + j;
+				if (empty)
+				{
+					minX = maxX = x;
+					minY = maxY = y;
+					empty = false;
+				}
+				else
+				{
+					minX = std::min(minX, x);
+					maxX = std::max(maxX, x);
+					minY = std::min(minY, y);
+					maxY = std::max(maxY, y);
+				}
+			}
 		}
-		return c;
-	};
-
-	int previousGridHeight = GRID_HEIGHT;	// to check if one dim is modified
+	}
 
-	int count = countVoid();
-	while (count == GRID_WIDTH)
+	// Streaming: chunks of the file that aren't resident count whole
+	if (m_streamer)
 	{
-		// delete row
-		for (auto& col : m_grid)
-			col.erase(col.begin());
-		--GRID_HEIGHT;
+		for (const auto& entry : m_streamer->getDirectory())
+		{
+			if (m_chunks.count(entry.first) != 0)
+				continue;
 
-		count = countVoid();
+			const sf::Vector2i origin = chunkFromKey(entry.first) * CHUNK_SIZEi;
+			if (empty)
+			{
+				minX = origin.x;
+				minY = origin.y;
+				maxX = origin.x + CHUNK_SIZEi - 1;
+				maxY = origin.y + CHUNK_SIZEi - 1;
+				empty = false;
+			}
+			else
+			{
+				minX = std::min(minX, origin.x);
+				minY = std::min(minY, origin.y);
+				maxX = std::max(maxX, origin.x + CHUNK_SIZEi - 1);
+				maxY = std::max(maxY, origin.y + CHUNK_SIZEi - 1);
+			}
+		}
 	}
 
-	return GRID_HEIGHT != previousGridHeight;
+	m_bounds = empty ? sf::IntRect() : sf::IntRect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+	m_boundsDirty = false;
 }
 
 char Map::getTileIndex(int x, int y) const
 {
-	if (x >= 0 && x < GRID_WIDTH && y >= 0 && y < GRID_HEIGHT)
-		return m_tilesMgr.getTileFromId(m_grid[x][y]).indexInFile;
-	else
-		return m_tilesMgr.getTileFromId(m_tilesMgr.getDefaultTile()).indexInFile;
+	return m_tilesMgr.getTileIndexFromId(getTile(x, y));
 }
 
 TileId Map::getTile(int x, int y) const
 {
-	if (x >= 0 && x < GRID_WIDTH && y >= 0 && y < GRID_HEIGHT)
-		return m_grid[x][y];
-	else
-	{
-		//std::cout << "getTileProperty: undef ref at " << x << ";" << y << std::endl;
+	auto it = m_chunks.find(makeChunkKey(tileToChunk(x), tileToChunk(y)));
+	if (it == m_chunks.end())	// nothing stored there
 		return m_tilesMgr.getDefaultTile();
-	}
+	return it->second.at(tileToLocal(x), tileToLocal(y));
 }
 
 Tile::Property Map::getTileProperty(int x, int y) const
@@ -384,77 +724,241 @@ Tile::Property Map::getTileProperty(int x, int y) const
 
 bool Map::touchingTile(const Box& box, Tile::Property tileProperty) const
 {
-	// Hypothetical values
-	int x_min = (int)std::floor(box.x / TILE_SIZEf);
-	int y_min = (int)std::floor(box.y / TILE_SIZEf);
-	int x_max = (int)std::ceil((box.x + box.w - 1) / TILE_SIZEf);
-	int y_max = (int)std::ceil((box.y + box.h - 1) / TILE_SIZEf);
+	return (touchedProperties(box) & Tile::bit(tileProperty)) != 0;
+}
+
+Tile::PropertyMask Map::touchedProperties(const Box& box) const
+{
+	// Tiles overlapped by [x, x + w) * [y, y + h), as in the sweeps
+	const int x_min = (int)std::floor((box.x + SWEEP_EPSILON) / TILE_SIZEf);
+	const int y_min = (int)std::floor((box.y + SWEEP_EPSILON) / TILE_SIZEf);
+	const int x_max = (int)std::ceil((box.x + box.w - SWEEP_EPSILON) / TILE_SIZEf);
+	const int y_max = (int)std::ceil((box.y + box.h - SWEEP_EPSILON) / TILE_SIZEf);
+
+	return touchedProperties(x_min, y_min, x_max, y_max);
+}
 
-	// Smarting values
-	if (x_min < 0)              x_min = 0;
-	if (y_min < 0)              y_min = 0;
-	if (x_max > GRID_WIDTH)     x_max = GRID_WIDTH;
-	// commented to use virtual ground
-	//if (y_max > GRID_HEIGHT)  y_max = GRID_HEIGHT;
+Tile::PropertyMask Map::touchedProperties(int x_min, int y_min, int x_max, int y_max) const
+{
+	Tile::PropertyMask touched = 0;
 
-	for (int i = x_min; i < x_max; ++i)
+	// Browse overlapped chunks, a few masked row reads each
+	for (int cy = tileToChunk(y_min); y_min < y_max && cy <= tileToChunk(y_max - 1); ++cy)
 	{
-		for (int j = y_min; j < y_max; ++j)
+		const int rowBegin = std::max(y_min - cy * CHUNK_SIZEi, 0);
+		const int rowEnd   = std::min(y_max - cy * CHUNK_SIZEi, CHUNK_SIZEi);
+
+		for (int cx = tileToChunk(x_min); x_min < x_max && cx <= tileToChunk(x_max - 1); ++cx)
 		{
-			if (getTileProperty(i, j) == tileProperty)
-				return true;
+			auto it = m_chunks.find(makeChunkKey(cx, cy));
+			if (it == m_chunks.end())	// nothing stored there
+			{
+				touched |= Tile::bit(m_tilesMgr.getTilePropertyFromId(m_tilesMgr.getDefaultTile()));
+				continue;
+			}
+
+			// bits [colBegin, colEnd) of each row
+			const int colBegin = std::max(x_min - cx * CHUNK_SIZEi, 0);
+			const int colEnd   = std::min(x_max - cx * CHUNK_SIZEi, CHUNK_SIZEi);
+			const auto colMask = (ChunkRow)(((1u << colEnd) - 1u) & ~((1u << colBegin) - 1u));
+
+			for (int p = 0; p < Tile::PROPERTY_COUNT; ++p)
+			{
+				const auto& plane = it->second.planes[p];
+				for (int row = rowBegin; row < rowEnd; ++row)
+				{
+					if (plane[row] & colMask)
+					{
+						touched |= Tile::bit((Tile::Property)p);
+						break;
+					}
+				}
+			}
 		}
 	}
 
 	if (y_max >= m_virtualGround)   // make the player unable to fall forever
 	{
-		std::cout << "Keeping the entity on a virtual ground" << std::endl;
-		// @return true
-		return true;
+		LOG_LIMITED(Debug, 1, "Keeping the entity on a virtual ground");
+		touched |= Tile::bit(Tile::Property::Solid);
+	}
+
+	return touched;
+}
+
+Map::Sweep Map::sweepX(const Box& box, float dx, Tile::Property tileProperty) const
+{
+	Sweep sweep;
+	if (dx == 0.f)
+		return sweep;
+
+	// Rows spanned by the box, the box is [x, x + w) * [y, y + h)
+	const int y_min = (int)std::floor((box.y + SWEEP_EPSILON) / TILE_SIZEf);
+	const int y_max = (int)std::ceil((box.y + box.h - SWEEP_EPSILON) / TILE_SIZEf);
+
+	// Walk the columns entered by the leading edge, in order, from the one it may overlap by less than SWEEP_EPSILON
+	const int step  = dx > 0.f ? 1 : -1;
+	const int first = dx > 0.f ? (int)std::ceil((box.x + box.w - SWEEP_EPSILON) / TILE_SIZEf) : (int)std::floor((box.x + SWEEP_EPSILON) / TILE_SIZEf) - 1;
+	const int last  = dx > 0.f ? (int)std::ceil((box.x + box.w + dx) / TILE_SIZEf) - 1 : (int)std::floor((box.x + dx) / TILE_SIZEf);
+
+	for (int col = first; (last - col) * step >= 0; col += step)
+	{
+		if (touchedProperties(col, y_min, col + 1, y_max) & Tile::bit(tileProperty))
+		{
+			// stop flush against the column
+			const float allowed = dx > 0.f
+				? (float)col * TILE_SIZEf - (box.x + box.w)
+				: (float)(col + 1) * TILE_SIZEf - box.x;
+			sweep.time = std::max(allowed / dx, 0.f);
+			sweep.normal = { -step, 0 };
+			break;
+		}
 	}
 
-	return false;
+	return sweep;
+}
+
+Map::Sweep Map::sweepY(const Box& box, float dy, Tile::Property tileProperty) const
+{
+	Sweep sweep;
+	if (dy == 0.f)
+		return sweep;
+
+	// Columns spanned by the box, the box is [x, x + w) * [y, y + h)
+	const int x_min = (int)std::floor((box.x + SWEEP_EPSILON) / TILE_SIZEf);
+	const int x_max = (int)std::ceil((box.x + box.w - SWEEP_EPSILON) / TILE_SIZEf);
+
+	// Walk the rows entered by the leading edge, in order, from the one it may overlap by less than SWEEP_EPSILON
+	const int step  = dy > 0.f ? 1 : -1;
+	const int first = dy > 0.f ? (int)std::ceil((box.y + box.h - SWEEP_EPSILON) / TILE_SIZEf) : (int)std::floor((box.y + SWEEP_EPSILON) / TILE_SIZEf) - 1;
+	const int last  = dy > 0.f ? (int)std::ceil((box.y + box.h + dy) / TILE_SIZEf) - 1 : (int)std::floor((box.y + dy) / TILE_SIZEf);
+
+	for (int row = first; (last - row) * step >= 0; row += step)
+	{
+		if (touchedProperties(x_min, row, x_max, row + 1) & Tile::bit(tileProperty))
+		{
+			// stop flush against the row
+			const float allowed = dy > 0.f
+				? (float)row * TILE_SIZEf - (box.y + box.h)
+				: (float)(row + 1) * TILE_SIZEf - box.y;
+			sweep.time = std::max(allowed / dy, 0.f);
+			sweep.normal = { 0, -step };
+			break;
+		}
+	}
+
+	return sweep;
 }
 
 sf::Vector2f Map::getWorldSize() const
 {
-	return sf::Vector2f(static_cast<float>(GRID_WIDTH), static_cast<float>(GRID_HEIGHT)) * TILE_SIZEf;
+	const sf::IntRect bounds = getBounds();
+	return sf::Vector2f(static_cast<float>(bounds.width), static_cast<float>(bounds.height)) * TILE_SIZEf;
+}
+
+void Map::indexChunk(TileChunk& chunk) const
+{
+	const TileId defaultTile = m_tilesMgr.getDefaultTile();
+
+	chunk.occupied = 0;
+	for (auto& plane : chunk.planes)
+		plane.fill(0);
+
+	for (int j = 0; j < CHUNK_SIZEi; ++j)
+	{
+		for (int i = 0; i < CHUNK_SIZEi; ++i)
+		{
+			const TileId tile = chunk.at(i, j);
+			chunk.planes[(int)m_tilesMgr.getTilePropertyFromId(tile)][j] |= (ChunkRow)(1u << i);
+			if (tile != defaultTile)
+				++chunk.occupied;
+		}
+	}
+}
+
+void Map::meshChunk(TileChunk& chunk, const sf::Vector2i& origin) const
+{
+	chunk.quads.fill(TileChunk::NO_QUAD);
+	chunk.quadCells.clear();
+	chunk.vertices.clear();
+
+	for (int j = 0; j < CHUNK_SIZEi; ++j)
+	{
+		for (int i = 0; i < CHUNK_SIZEi; ++i)
+			updateQuad(chunk, origin.x + i, origin.y + j);
+	}
+
+	chunk.bufferDirty = true;
 }
 
 void Map::regenerateVertices()
 {
-	m_vertices.clear();
+	// creates an optimized (smaller than the grid) vertex array per chunk
+	for (auto& [key, chunk] : m_chunks)
+		meshChunk(chunk, chunkFromKey(key) * CHUNK_SIZEi);
+}
+
+void Map::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	PROFILE_ZONE("Map::draw");
+	states.texture = m_texture;
+
+	// Only chunks intersecting the view are drawn
+	const sf::View& view = target.getView();
+	const sf::Vector2f topLeft = view.getCenter() - view.getSize() / 2.f;
+	const float chunkSize = TILE_SIZEf * CHUNK_SIZEi;
 
-	// creates an optimized (smaller than m_grid) vertex array
-	for (int i = 0; i < GRID_WIDTH; ++i)
+	const int minX = (int)std::floor(topLeft.x / chunkSize);
+	const int minY = (int)std::floor(topLeft.y / chunkSize);
+	const int maxX = (int)std::floor((topLeft.x + view.getSize().x) / chunkSize);
+	const int maxY = (int)std::floor((topLeft.y + view.getSize().y) / chunkSize);
+
+	const auto visibleCount = (std::size_t)(maxX - minX + 1) * (std::size_t)(maxY - minY + 1);
+	if (visibleCount <= m_chunks.size())
 	{
-		for (int j = 0; j < GRID_HEIGHT; ++j)
+		for (int cy = minY; cy <= maxY; ++cy)
 		{
-			if (getTileProperty(i, j) != Tile::Property::Void)  // reduce vertices number
+			for (int cx = minX; cx <= maxX; ++cx)
 			{
-				// set position & texture coords
-				auto& texCoords = m_tilesMgr.getTileTexCoordsFromId(getTile(i, j));   // for read-ability
-
-				m_vertices.emplace_back(
-					sf::Vector2f(i * TILE_SIZEi,j * TILE_SIZEi),
-					texCoords);
-				m_vertices.emplace_back(
-					sf::Vector2f((i + 1) * TILE_SIZEi,j * TILE_SIZEi),
-					sf::Vector2f(texCoords.x + TILE_SIZEi, texCoords.y));
-				m_vertices.emplace_back(
-					sf::Vector2f((i + 1) * TILE_SIZEi, (j + 1) * TILE_SIZEi),
-					sf::Vector2f(texCoords.x + TILE_SIZEi, texCoords.y + TILE_SIZEi));
-				m_vertices.emplace_back(
-					sf::Vector2f( i * TILE_SIZEi, (j + 1) * TILE_SIZEi),
-					sf::Vector2f(texCoords.x, texCoords.y + TILE_SIZEi));
+				auto it = m_chunks.find(makeChunkKey(cx, cy));
+				if (it != m_chunks.end())
+					drawChunk(it->first, it->second, target, states);
 			}
 		}
 	}
+	else	// zoomed out further than the map: cheaper to test every chunk
+	{
+		for (const auto& [key, chunk] : m_chunks)
+		{
+			const sf::Vector2i c = chunkFromKey(key);
+			if (c.x >= minX && c.x <= maxX && c.y >= minY && c.y <= maxY)
+				drawChunk(key, chunk, target, states);
+		}
+	}
 }
 
-void Map::draw(sf::RenderTarget& target, sf::RenderStates states) const
+void Map::drawChunk(ChunkKey key, const TileChunk& chunk, sf::RenderTarget& target, const sf::RenderStates& states) const
 {
-	states.texture = m_texture;
-	if (!m_vertices.empty())
-		target.draw(&m_vertices[0], m_vertices.size(), sf::Quads, states);
+	if (chunk.vertices.empty())
+		return;
+
+	// Checked once, needs an OpenGL context
+	static const bool useVertexBuffers = sf::VertexBuffer::isAvailable();
+	if (!useVertexBuffers)
+	{
+		RenderStats::draw(target, &chunk.vertices[0], chunk.vertices.size(), sf::Quads, states);
+		return;
+	}
+
+	auto [it, created] = m_chunkBuffers.try_emplace(key, sf::Quads, sf::VertexBuffer::Static);
+	sf::VertexBuffer& buffer = it->second;
+	if (chunk.bufferDirty || created)	// re-upload to the GPU only once per modification
+	{
+		if (buffer.getVertexCount() != chunk.vertices.size())
+			buffer.create(chunk.vertices.size());
+		buffer.update(&chunk.vertices[0]);
+		chunk.bufferDirty = false;
+	}
+
+	RenderStats::draw(target, buffer, states);
 }
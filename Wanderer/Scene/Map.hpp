@@ -2,64 +2,135 @@
 
 #include "TilesManager.hpp"
 #include "Scene/Tile.hpp"
+#include "Scene/TileChunk.hpp"
+#include "Scene/LevelFile.hpp"
 #include "Utility/Box.hpp"
 
 #include <SFML/Graphics.hpp>
 #include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <string>
 
+class ChunkStreamer;
+
 class Map : public sf::Drawable
 {
 public:
-	explicit Map(TilesManager& mt) : m_tilesMgr(mt) {}
-	~Map() override = default;
+	explicit Map(TilesManager& mt);
+	~Map() override;
 
 	[[maybe_unused]] void printGrid();
 
 	void setTexture(const sf::Texture& texture) { m_texture = &texture; }
-	bool load(const std::string& filename);
+	bool load(const std::string& filename);		// plain text map.txt
+	bool save(const std::string& filename) const;	// plain text map.txt of getBounds(), see load()
+	bool load(const LevelFile& levelFile);		// binary level.bin
+	void clear();	// also stops streaming: call it before changing the tiles registry
+
+	// Streaming: only chunks around the camera are resident, decoded and meshed on a background thread
+	bool stream(std::unique_ptr<LevelFile> levelFile);
+	void updateStreaming(const sf::Vector2f& center);	// once per frame, center in world coordinates
+	void streamInAround(const sf::Vector2f& center);	// chunks in range are loaded now, not on the next frames
+	void stopStreaming();	// loads every remaining chunk, the map is then fully resident
+	[[nodiscard]] bool isStreaming() const { return m_streamer != nullptr; }
+	void setStreamingRadius(int radius);
+	[[nodiscard]] int getStreamingRadius() const;
+	[[nodiscard]] bool isActiveAt(const sf::Vector2f& position) const;	// entities there should be updated
+	[[nodiscard]] std::vector<LevelChunk> exportChunks() const;	// cells are TileIds: the tiles registry is the palette
 	[[nodiscard]] const std::string& getLevelFilename() const;
 
-	void setTile(int x, int y, TileId newTile, bool* newColLeft = nullptr, bool* newRowTop = nullptr);
+	// Tile coordinates are world coordinates: any (x, y) is valid, even negative ones
+	void setTile(int x, int y, TileId newTile);
 
-	void addColsRight	(std::size_t n);
-	void addColsLeft	(std::size_t n);
-	void addRowsBottom	(std::size_t n);
-	void addRowsTop		(std::size_t n);
+	/** Edit transaction: between beginEdit() and endEdit(), setTile() only stores tiles and bitplanes.
+	 * Quads of every modified chunk are rebuilt once by the outermost endEdit() **/
+	void beginEdit();
+	void endEdit();
 
-	void removeEmptyColsRight();
-	bool removeEmptyColsLeft();
-	void removeEmptyRowsBottom();
-	bool removeEmptyRowsTop();
+	// 4-connected, one transaction, bounded by the map bounds + 1 tile margin. Stops streaming: it reads any cell of the area
+	void floodFill(const sf::Vector2i& start, TileId tile);
 
 	[[nodiscard]] char getTileIndex(int x, int y) const;
 	[[nodiscard]] TileId getTile(int x, int y) const;    // get tile from index
 	[[nodiscard]] Tile::Property getTileProperty(int x, int y) const;
 
 	[[nodiscard]] bool touchingTile(const Box& box, Tile::Property tileProperty) const;
+	[[nodiscard]] Tile::PropertyMask touchedProperties(const Box& box) const;	// every property overlapped by box
+
+	/** Result of a sweep: how far the box could go before entering a tile with the wanted property **/
+	struct Sweep
+	{
+		float time = 1.f;		// fraction of the movement done, 1 if nothing was hit
+		sf::Vector2i normal;	// contact normal, (0, 0) if nothing was hit
+	};
+
+	// Continuous, one axis at a time: every tile row/column crossed is checked, nothing can be tunneled through.
+	// Positions are fractional: a box overlapping a tile by less than SWEEP_EPSILON (rounding of a previous stop) is flush against it
+	static constexpr float SWEEP_EPSILON = 1.f / 256.f;
+	[[nodiscard]] Sweep sweepX(const Box& box, float dx, Tile::Property tileProperty) const;
+	[[nodiscard]] Sweep sweepY(const Box& box, float dy, Tile::Property tileProperty) const;
+	[[nodiscard]] sf::IntRect getBounds() const;	// smallest tile rect holding every non-default tile
 	[[nodiscard]] sf::Vector2f getWorldSize() const;
+	[[nodiscard]] std::size_t getChunkCount() const { return m_chunks.size(); }
 
 private:
 	friend class MapEditor;
-
-	/** heavy internal method called everytime grid is modified **/
+	friend class ChunkStreamer;
+	friend class Benchmark;		// times regenerateVertices()
+	friend struct MapTests;		// checks the chunks internals, see tests.cpp
+
+	/** writes one cell, creating or dropping its chunk.
+	 * Returns the chunk holding the cell, nullptr if the cell already held newTile or if the chunk was dropped **/
+	TileChunk* storeTile(int x, int y, TileId newTile);
+	void recomputeBounds() const;
+
+	// Tile range version of touchedProperties(), bounds are half-open: [x_min, x_max) x [y_min, y_max)
+	[[nodiscard]] Tile::PropertyMask touchedProperties(int x_min, int y_min, int x_max, int y_max) const;
+
+	// Quads: setTile() patches, appends or swap-removes the single quad of the modified cell
+	void updateQuad(TileChunk& chunk, int x, int y) const;
+	void writeQuad(TileChunk& chunk, int quad, int x, int y, TileId tile) const;
+	static void removeQuad(TileChunk& chunk, int quad);
+
+	// Rebuild derived data of a chunk from its tiles. Const: also used by the streaming thread
+	void indexChunk(TileChunk& chunk) const;	// occupancy and collision bitplanes
+	void meshChunk(TileChunk& chunk, const sf::Vector2i& origin) const;	// quads
+	TileChunk* streamInNow(ChunkKey key);
+	[[nodiscard]] std::vector<TileId> makeSlotTable(const LevelFile& levelFile) const;	// level palette slot to TileId
+
+	/** heavy internal method rebuilding every quad, only called on load **/
 	void regenerateVertices();
 	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+	void drawChunk(ChunkKey key, const TileChunk& chunk, sf::RenderTarget& target, const sf::RenderStates& states) const;
+	void eraseChunk(std::unordered_map<ChunkKey, TileChunk>::iterator it);	// with its GPU buffer
 
 private:
-	// Grid
-	std::vector< std::vector<TileId> > m_grid;	// Pointers shouldn't be invalidated, nor be nullptr
-	int GRID_WIDTH = 0;
-	int GRID_HEIGHT = 0;
-	const sf::Vector2i m_minimumGridSize { 3, 3 };
+	// Grid: sparse, only chunks with at least one non-default tile exist. Tile (0, 0) never moves
+	std::unordered_map<ChunkKey, TileChunk> m_chunks;
+	mutable sf::IntRect m_bounds;			// see getBounds()
+	mutable bool m_boundsDirty = false;		// a tile on the edge was removed, bounds may shrink
 
 	// Tiles list
 	TilesManager& m_tilesMgr;	// Helper that boxContains all posible tiles grid  refers to
 
 	// Graphics
-	const sf::Texture* m_texture = nullptr;
-	std::vector<sf::Vertex> m_vertices;
+	const sf::Texture* m_texture = nullptr;	// vertices are stored in the chunks
+	// GPU copies of the chunks drawn so far, created by draw() only: the render thread owns every GL resource
+	mutable std::unordered_map<ChunkKey, sf::VertexBuffer> m_chunkBuffers;
+
+	// Streaming
+	std::unique_ptr<ChunkStreamer> m_streamer;	// nullptr: every chunk is resident
+	std::vector<std::pair<ChunkKey, TileChunk>> m_streamedIn;	// reused buffer
+	std::vector<std::pair<std::uint32_t, ChunkKey>> m_evictionCandidates;	// reused buffer: { lastUsed, chunk }
+	std::uint32_t m_streamingFrame = 0;
+	sf::Vector2i m_streamingCenter;	// chunk coordinates
+
+	// Edit transactions
+	int m_editDepth = 0;	// nested beginEdit() calls
+	std::unordered_set<ChunkKey> m_editedChunks;	// quads to rebuild in endEdit()
 
 	// Behavior
 	int m_virtualGround = -1;	// entities won't fall forever
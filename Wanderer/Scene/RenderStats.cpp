@@ -0,0 +1,100 @@
+#include "Scene/RenderStats.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+RenderStats::Frame RenderStats::s_frame;
+RenderStats::Frame RenderStats::s_lastFrame;
+std::size_t RenderStats::s_group = MAX_GROUPS;
+bool RenderStats::s_hasPreviousDraw = false;
+sf::RenderStates RenderStats::s_previousStates;
+std::array<float, RenderStats::FRAME_HISTORY> RenderStats::s_frameTimes{};
+std::uint64_t RenderStats::s_frameCount = 0;
+
+void RenderStats::beginFrame(float lastFrameTime)
+{
+	s_frameTimes[s_frameCount % FRAME_HISTORY] = lastFrameTime;
+	++s_frameCount;
+
+	s_lastFrame = s_frame;
+	s_frame = Frame();
+	s_group = MAX_GROUPS;
+	s_hasPreviousDraw = false;	// ImGui rendered in between: the first draw sets every state again
+}
+
+void RenderStats::setGroup(const char* name)
+{
+	for (s_group = 0; s_group < s_frame.groupCount; ++s_group)
+	{
+		if (std::strcmp(s_frame.names[s_group], name) == 0)
+			return;
+	}
+
+	if (s_frame.groupCount == MAX_GROUPS)
+	{
+		s_group = MAX_GROUPS - 1;
+		return;
+	}
+	s_frame.names[s_frame.groupCount] = name;
+	s_group = s_frame.groupCount++;
+}
+
+void RenderStats::count(std::size_t vertices, const sf::RenderStates& states)
+{
+	if (s_group == MAX_GROUPS)
+		setGroup("other");
+
+	Counters& counters = s_frame.groups[s_group];
+	++counters.drawCalls;
+	counters.vertices += (std::uint32_t)vertices;
+
+	// sf::Transform has no operator== before SFML 2.6
+	const float* matrix = states.transform.getMatrix();
+	const float* previousMatrix = s_previousStates.transform.getMatrix();
+	if (!s_hasPreviousDraw || states.texture != s_previousStates.texture)
+		++counters.textureChanges;
+	if (!s_hasPreviousDraw || states.shader != s_previousStates.shader || !(states.blendMode == s_previousStates.blendMode)
+		|| !std::equal(matrix, matrix + 16, previousMatrix))
+		++counters.stateChanges;
+
+	s_hasPreviousDraw = true;
+	s_previousStates = states;
+}
+
+void RenderStats::draw(sf::RenderTarget& target, const sf::Vertex* vertices, std::size_t count, sf::PrimitiveType type, const sf::RenderStates& states)
+{
+	RenderStats::count(count, states);
+	target.draw(vertices, count, type, states);
+}
+
+void RenderStats::draw(sf::RenderTarget& target, const sf::VertexBuffer& buffer, const sf::RenderStates& states)
+{
+	count(buffer.getVertexCount(), states);
+	target.draw(buffer, states);
+}
+
+// The two below count what sf::Sprite::draw and sf::Shape::draw submit
+
+void RenderStats::draw(sf::RenderTarget& target, const sf::Sprite& sprite, sf::RenderStates states)
+{
+	target.draw(sprite, states);
+
+	states.transform *= sprite.getTransform();
+	states.texture = sprite.getTexture();
+	count(4, states);
+}
+
+void RenderStats::draw(sf::RenderTarget& target, const sf::Shape& shape, sf::RenderStates states)
+{
+	target.draw(shape, states);
+
+	states.transform *= shape.getTransform();
+	states.texture = shape.getTexture();
+	count(shape.getPointCount() + 2, states);	// triangle fan: center + points + first point again
+
+	if (shape.getOutlineThickness() != 0.f)
+	{
+		states.texture = nullptr;
+		count((shape.getPointCount() + 1) * 2, states);
+	}
+}
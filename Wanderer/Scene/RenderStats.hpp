@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstdint>
+
+/** What a frame submits to the GPU, by group (one per scene layer), and the frame times of the last seconds.
+ *
+ *  sf::RenderTarget::draw isn't virtual: a target wrapping the window wouldn't see the draws the drawables make.
+ *  The engine's drawables draw through RenderStats::draw() instead, which counts then forwards to the target.
+ *  ImGui renders with OpenGL directly and isn't counted. Main thread only **/
+class RenderStats
+{
+public:
+	static constexpr std::size_t MAX_GROUPS = 8;	// more share the last one
+	static constexpr std::size_t FRAME_HISTORY = 600;	// 10 s at 60 FPS
+
+	struct Counters
+	{
+		std::uint32_t drawCalls = 0;
+		std::uint32_t vertices = 0;
+		std::uint32_t textureChanges = 0;	// draws binding another texture than the previous draw
+		std::uint32_t stateChanges = 0;	// draws with another blend mode, shader or transform than the previous draw
+	};
+
+	// Before drawing: the counters of the previous frame are kept for display
+	static void beginFrame(float lastFrameTime);
+	static void setGroup(const char* name);	// the next draws are counted in this group, literal only
+
+	// Same as target.draw(...), counted
+	static void draw(sf::RenderTarget& target, const sf::Vertex* vertices, std::size_t count, sf::PrimitiveType type, const sf::RenderStates& states);
+	static void draw(sf::RenderTarget& target, const sf::VertexBuffer& buffer, const sf::RenderStates& states);
+	static void draw(sf::RenderTarget& target, const sf::Sprite& sprite, sf::RenderStates states);
+	static void draw(sf::RenderTarget& target, const sf::Shape& shape, sf::RenderStates states);	// fill, then outline
+
+	static void drawImGui();	// see RenderStatsView.cpp
+
+private:
+	struct Frame
+	{
+		std::array<const char*, MAX_GROUPS> names{};
+		std::array<Counters, MAX_GROUPS> groups{};
+		std::size_t groupCount = 0;
+	};
+
+	static void count(std::size_t vertices, const sf::RenderStates& states);	// one draw call
+
+	static Frame s_frame;	// being drawn
+	static Frame s_lastFrame;	// shown
+	static std::size_t s_group;	// in s_frame, MAX_GROUPS: none yet
+
+	// Previous draw, to detect changes
+	static bool s_hasPreviousDraw;
+	static sf::RenderStates s_previousStates;
+
+	static std::array<float, FRAME_HISTORY> s_frameTimes;	// seconds, ring
+	static std::uint64_t s_frameCount;
+};
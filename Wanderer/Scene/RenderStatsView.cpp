@@ -0,0 +1,68 @@
+#include "Scene/RenderStats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+
+#include <imgui.h>
+
+// Kept apart from RenderStats.cpp: targets without imgui (headless, benchmark) still compile the counting draws
+
+void RenderStats::drawImGui()
+{
+	if (!ImGui::Begin("Render stats"))
+	{
+		ImGui::End();
+		return;
+	}
+
+	// Last complete frame, by group then in total
+	ImGui::Text("%-12s %6s %8s %8s %6s", "group", "draws", "vertices", "textures", "states");
+	Counters total;
+	for (std::size_t i = 0; i < s_lastFrame.groupCount; ++i)
+	{
+		const Counters& group = s_lastFrame.groups[i];
+		ImGui::Text("%-12s %6u %8u %8u %6u", s_lastFrame.names[i], group.drawCalls, group.vertices, group.textureChanges, group.stateChanges);
+		total.drawCalls += group.drawCalls;
+		total.vertices += group.vertices;
+		total.textureChanges += group.textureChanges;
+		total.stateChanges += group.stateChanges;
+	}
+	ImGui::Text("%-12s %6u %8u %8u %6u", "total", total.drawCalls, total.vertices, total.textureChanges, total.stateChanges);
+
+	const std::size_t frames = (std::size_t)std::min<std::uint64_t>(s_frameCount, FRAME_HISTORY);
+	if (frames == 0)
+	{
+		ImGui::End();
+		return;
+	}
+
+	// Frame times of the last seconds: distribution by 1 ms bins, the last one gathers the slower frames
+	constexpr std::size_t BINS = 40;
+	std::array<float, BINS> bins{};
+	std::array<float, FRAME_HISTORY> sorted;
+	for (std::size_t i = 0; i < frames; ++i)
+	{
+		const float milliseconds = s_frameTimes[i] * 1000.f;
+		bins[std::min((std::size_t)milliseconds, BINS - 1)] += 1.f;
+		sorted[i] = milliseconds;
+	}
+	ImGui::PlotHistogram("Frame times (0-40 ms)", bins.data(), (int)BINS, 0, nullptr, 0.f, FLT_MAX, ImVec2(0, 60));
+
+	auto percentile = [&](float p)
+	{
+		const std::size_t rank = std::min((std::size_t)(p * (float)frames), frames - 1);
+		std::nth_element(sorted.begin(), sorted.begin() + (std::ptrdiff_t)rank, sorted.begin() + (std::ptrdiff_t)frames);
+		return sorted[rank];
+	};
+	const float p50 = percentile(0.50f);
+	const float p95 = percentile(0.95f);
+	const float p99 = percentile(0.99f);
+	const float worst = *std::max_element(sorted.begin(), sorted.begin() + (std::ptrdiff_t)frames);
+	ImGui::Text("%zu frames: p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, worst %.2f ms", frames, p50, p95, p99, worst);
+
+	const float last = s_frameTimes[(s_frameCount - 1) % FRAME_HISTORY];
+	ImGui::Text("Last frame %.2f ms (%.0f FPS)", last * 1000.f, last > 0.f ? 1.f / last : 0.f);
+
+	ImGui::End();
+}
@@ -0,0 +1,206 @@
+#include "Scene/Replay.hpp"
+#include "Constants.hpp"
+#include "Utility/LittleEndian.hpp"
+#include "Utility/Logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+	const char MAGIC[4] = { 'W', 'R', 'P', 'L' };
+	const std::size_t HEADER_SIZE = 20;
+	const std::size_t CHANGE_SIZE = 5;
+	const std::size_t FINAL_STATE_SIZE = 13;
+
+	std::uint8_t packInput(const PlayerInput& input)
+	{
+		return (std::uint8_t)(input.left | (input.right << 1) | (input.jump << 2) | (input.up << 3) | (input.down << 4));
+	}
+
+	PlayerInput unpackInput(std::uint8_t bits)
+	{
+		PlayerInput input;
+		input.left = bits & 1;
+		input.right = bits & 2;
+		input.jump = bits & 4;
+		input.up = bits & 8;
+		input.down = bits & 16;
+		return input;
+	}
+}
+
+Replay::PlayerState Replay::PlayerState::capture(const Simulation& simulation)
+{
+	const World& world = simulation.getWorld();
+	const std::size_t player = simulation.getPlayer();
+	return { world.positions[player].x, world.positions[player].y, world.healths[player].hp, (std::uint8_t)world.kinematics[player].yState };
+}
+
+void Replay::clear(const std::string& level)
+{
+	m_level = level;
+	m_inputs.clear();
+	m_lastInput = PlayerInput();
+	m_checksums.clear();
+	m_finalState = PlayerState();
+}
+
+void Replay::record(const PlayerInput& input, const Simulation& simulation)
+{
+	if (m_checksums.empty() || input != m_lastInput)
+		m_inputs.add(m_checksums.size(), input);
+	m_lastInput = input;
+	m_checksums.push_back(simulation.computeChecksum());
+	m_finalState = PlayerState::capture(simulation);
+}
+
+bool Replay::save(const std::string& filename) const
+{
+	const auto& changes = m_inputs.getChanges();
+
+	std::vector<unsigned char> out;
+	out.reserve(HEADER_SIZE + m_level.size() + changes.size() * CHANGE_SIZE + m_checksums.size() * 4 + FINAL_STATE_SIZE);
+	out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+	writeU16(out, VERSION);
+	writeU16(out, (std::uint16_t)m_level.size());
+	writeF32(out, SIMULATION_RATE);
+	writeU32(out, (std::uint32_t)m_checksums.size());
+	writeU32(out, (std::uint32_t)changes.size());
+
+	out.insert(out.end(), m_level.begin(), m_level.end());
+	for (const auto& [tick, input] : changes)
+	{
+		writeU32(out, (std::uint32_t)tick);
+		out.push_back(packInput(input));
+	}
+	for (std::uint32_t checksum : m_checksums)
+		writeU32(out, checksum);
+
+	writeF32(out, m_finalState.x);
+	writeF32(out, m_finalState.y);
+	writeU32(out, m_finalState.hp);
+	out.push_back(m_finalState.yState);
+
+	std::ofstream stream(filename, std::ios::binary);
+	if (!stream)
+	{
+		std::cerr << "Replay: couldn't create " << filename << std::endl;
+		return false;
+	}
+	stream.write(reinterpret_cast<const char*>(out.data()), (std::streamsize)out.size());
+	return (bool)stream;
+}
+
+bool Replay::load(const std::string& filename)
+{
+	std::ifstream stream(filename, std::ios::binary);
+	if (!stream)
+	{
+		std::cerr << "Failed to open: " << filename << std::endl;
+		return false;
+	}
+	const std::vector<unsigned char> in((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	auto fail = [&](const char* reason)
+	{
+		std::cerr << "Replay: " << filename << ": " << reason << std::endl;
+		return false;
+	};
+
+	if (in.size() < HEADER_SIZE || std::memcmp(in.data(), MAGIC, sizeof(MAGIC)) != 0)
+		return fail("not a replay");
+	if (readU16(in.data() + 4) != VERSION)
+		return fail("unsupported version");
+	if (readF32(in.data() + 8) != SIMULATION_RATE)
+		return fail("recorded at another simulation rate");
+
+	const std::size_t levelLength = readU16(in.data() + 6);
+	const std::size_t tickCount = readU32(in.data() + 12);
+	const std::size_t changeCount = readU32(in.data() + 16);
+	if (in.size() != HEADER_SIZE + levelLength + changeCount * CHANGE_SIZE + tickCount * 4 + FINAL_STATE_SIZE)
+		return fail("truncated or corrupted");
+
+	const unsigned char* p = in.data() + HEADER_SIZE;
+	clear(std::string(reinterpret_cast<const char*>(p), levelLength));
+	p += levelLength;
+
+	for (std::size_t i = 0; i < changeCount; ++i, p += CHANGE_SIZE)
+	{
+		const std::uint64_t tick = readU32(p);
+		if (!m_inputs.empty() && tick <= m_inputs.getLastTick())
+			return fail("input changes out of order");
+		m_inputs.add(tick, unpackInput(p[4]));
+	}
+
+	m_checksums.resize(tickCount);
+	for (std::size_t i = 0; i < tickCount; ++i, p += 4)
+		m_checksums[i] = readU32(p);
+
+	m_finalState = { readF32(p), readF32(p + 4), readU32(p + 8), p[12] };
+	return true;
+}
+
+ReplayPlayer::ReplayPlayer(Simulation& simulation, const Replay& replay)
+	: m_simulation(simulation), m_replay(replay)
+{
+}
+
+bool ReplayPlayer::start()
+{
+	m_keyframes.clear();
+	m_divergentTick = NO_DIVERGENCE;
+	m_finalStateMatching = false;
+
+	if (m_simulation.getTick() != 0)
+	{
+		std::cerr << "Replay: the level must be loaded again before playing" << std::endl;
+		return false;
+	}
+	m_simulation.getMap().stopStreaming();
+
+	m_keyframes.emplace_back();
+	m_simulation.saveKeyframe(m_keyframes.back());
+	return true;
+}
+
+void ReplayPlayer::step()
+{
+	if (isFinished())
+		return;
+
+	const std::uint64_t tick = getTick();
+	m_simulation.step(m_replay.getInput(tick), SIMULATION_STEP);
+
+	if (tick < m_divergentTick && m_simulation.computeChecksum() != m_replay.getChecksum(tick))
+	{
+		m_divergentTick = tick;
+		LOG(Error, "Replay diverged at tick %llu", (unsigned long long)tick);
+	}
+	if (isFinished())
+		m_finalStateMatching = Replay::PlayerState::capture(m_simulation) == m_replay.getFinalState();
+
+	// Keyframes are taken the first time a tick is reached, seeking back replays over them
+	const std::uint64_t next = getTick();
+	if (next % KEYFRAME_INTERVAL == 0 && next / KEYFRAME_INTERVAL == m_keyframes.size())
+	{
+		m_keyframes.emplace_back();
+		m_simulation.saveKeyframe(m_keyframes.back());
+	}
+}
+
+void ReplayPlayer::seek(std::uint64_t tick)
+{
+	tick = std::min(tick, m_replay.getTickCount());
+
+	// Backward, or forward beyond the next keyframe: restart from the last keyframe before tick
+	const std::size_t keyframe = (std::size_t)std::min<std::uint64_t>(tick / KEYFRAME_INTERVAL, m_keyframes.size() - 1);
+	if (tick < getTick() || keyframe * KEYFRAME_INTERVAL > getTick())
+		m_simulation.restoreKeyframe(m_keyframes[keyframe]);
+
+	while (getTick() < tick)
+		step();
+}
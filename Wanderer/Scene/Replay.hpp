@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Scene/Simulation.hpp"
+#include "Scene/InputScript.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Recorded session: the level, the player inputs and a checksum of the simulation after every tick.
+ *  Binary file (.wrpl), little-endian:
+ *
+ *  header     "WRPL", u16 version, u16 levelLength, f32 simulationRate, u32 tickCount, u32 changeCount
+ *  level      levelLength chars: the level directory given to Simulation::loadLevel
+ *  changes    changeCount * { u32 tick, u8 controls }: held from that tick on, bit 0 left ... bit 4 down
+ *  checksums  tickCount * u32: Simulation::computeChecksum() after each tick
+ *  final      f32 playerX, f32 playerY, u32 playerHp, u8 playerYState: the player after the last tick
+ *
+ *  The simulation has no randomness: the level and the inputs are enough to replay it **/
+class Replay
+{
+public:
+	static constexpr std::uint16_t VERSION = 2;
+
+	/** The player at the end of the recording, compared as is at the end of a playback: readable where a checksum isn't **/
+	struct PlayerState
+	{
+		float x = 0.f, y = 0.f;
+		std::uint32_t hp = 0;
+		std::uint8_t yState = 0;
+
+		static PlayerState capture(const Simulation& simulation);
+		bool operator==(const PlayerState& o) const { return x == o.x && y == o.y && hp == o.hp && yState == o.yState; }
+	};
+
+	void clear(const std::string& level);
+	void record(const PlayerInput& input, const Simulation& simulation);	// the next tick, after it was simulated
+
+	bool save(const std::string& filename) const;
+	bool load(const std::string& filename);
+
+	[[nodiscard]] const std::string& getLevel() const { return m_level; }
+	[[nodiscard]] std::uint64_t getTickCount() const { return m_checksums.size(); }
+	[[nodiscard]] PlayerInput getInput(std::uint64_t tick) const { return m_inputs.at(tick); }
+	[[nodiscard]] std::uint32_t getChecksum(std::uint64_t tick) const { return m_checksums[tick]; }
+	[[nodiscard]] const PlayerState& getFinalState() const { return m_finalState; }
+
+private:
+	std::string m_level;
+	InputScript m_inputs;	// changes only: a held key costs nothing per tick
+	PlayerInput m_lastInput;
+	std::vector<std::uint32_t> m_checksums;
+	PlayerState m_finalState;
+};
+
+/** Plays a Replay back into a Simulation and checks each tick against the recorded checksum.
+ *  A keyframe is kept every KEYFRAME_INTERVAL ticks: seek() simulates at most that many ticks **/
+class ReplayPlayer
+{
+public:
+	static constexpr std::uint64_t NO_DIVERGENCE = (std::uint64_t)-1;
+	static constexpr std::uint64_t KEYFRAME_INTERVAL = 300;	// ticks, 5 s
+
+	ReplayPlayer(Simulation& simulation, const Replay& replay);
+
+	// On the level just loaded: Simulation::loadLevel(replay.getLevel()) first. The map is made fully resident:
+	// streaming timing would change which entities are frozen
+	bool start();
+	void step();	// one tick, nothing once finished
+	void seek(std::uint64_t tick);
+
+	[[nodiscard]] std::uint64_t getTick() const { return m_simulation.getTick(); }
+	[[nodiscard]] bool isFinished() const { return getTick() >= m_replay.getTickCount(); }
+	[[nodiscard]] std::uint64_t getDivergentTick() const { return m_divergentTick; }	// first one, NO_DIVERGENCE if none
+	[[nodiscard]] bool isFinalStateMatching() const { return m_finalStateMatching; }	// once finished, see Replay::PlayerState
+
+private:
+	Simulation& m_simulation;
+	const Replay& m_replay;
+	std::vector<Simulation::Keyframe> m_keyframes;	// keyframe i is at tick i * KEYFRAME_INTERVAL
+	std::uint64_t m_divergentTick = NO_DIVERGENCE;
+	bool m_finalStateMatching = false;
+};
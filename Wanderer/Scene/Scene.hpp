@@ -1,7 +1,8 @@
 #pragma once
 
+#include "Utility/Logger.hpp"
+
 #include <SFML/Graphics.hpp>
-#include <iostream>
 
 
 class Scene
@@ -10,17 +11,18 @@ public:
 	explicit Scene(sf::RenderWindow* window)
         : m_window(window)
     {
-        std::cerr << "Creating a new scene (" << this << ')' << std::endl;
+        LOG(Debug, "Creating a new scene (%p)", (void*)this);
     }
 	virtual ~Scene()
     {
-        std::cerr << "Destroying a scene (" << this << ')' << std::endl;
+        LOG(Debug, "Destroying a scene (%p)", (void*)this);
     }
 
 	virtual void handleEvent(const sf::Event& event) = 0;
-	virtual void checkInput() = 0;
-	virtual void update(float dt) = 0;
-	virtual void draw(sf::RenderTarget& target) = 0;
+	virtual void checkInput() = 0;	// once per frame, before the steps: editor and debug keys
+	virtual void update(float dt) = 0;	// one fixed simulation step, see SceneManager::run(). Samples the simulation inputs
+	// interpolation: fraction of a simulation step elapsed since the last update(), in [0, 1)
+	virtual void draw(sf::RenderTarget& target, float interpolation) = 0;
 
 protected:
 	sf::RenderWindow* m_window;
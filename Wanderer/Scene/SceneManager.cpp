@@ -1,7 +1,11 @@
 #include <imgui-SFML.h>
 #include "Scene/SceneManager.hpp"
 #include "Scene/GameScene.hpp"
+#include "Scene/RenderStats.hpp"
 #include "Constants.hpp"
+#include "Utility/AllocationTracker.hpp"
+#include "Utility/Logger.hpp"
+#include "Utility/Profiler.hpp"
 
 SceneManager::SceneManager()
 {
@@ -26,34 +30,86 @@ void SceneManager::setCurrentScene(Scene* currentScene)
 void SceneManager::run()
 {
 	ImGui::SFML::Init(m_window);
+	Profiler::setThreadName("main");
 
+	const sf::Time step = sf::seconds(1.f / SIMULATION_RATE);
 	sf::Clock clock;
+	sf::Time accumulator = sf::Time::Zero;
 
 	while (m_window.isOpen())
 	{
+		Profiler::beginFrame();
+		PROFILE_ZONE("frame");
+		const std::uint64_t frameAllocations = AllocationTracker::getThreadAllocations();
+
 		sf::Event event{};
-		while (m_window.pollEvent(event))
 		{
-			ImGui::SFML::ProcessEvent(event);
+			PROFILE_ZONE("events");
+			while (m_window.pollEvent(event))
+			{
+				ImGui::SFML::ProcessEvent(event);
+
+				if (event.type == sf::Event::Closed || (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape))
+					m_window.close();
+				else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F9)
+					Profiler::exportChromeTrace("profile.json");
+				else
+					m_currentScene->handleEvent(event);
+			}
+		}
 
-			if (event.type == sf::Event::Closed || (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape))
-				m_window.close();
-			else
-				m_currentScene->handleEvent(event);
+		const sf::Time frameTime = clock.restart();
+		RenderStats::beginFrame(frameTime.asSeconds());
+		{
+			PROFILE_ZONE("imgui update");
+			ImGui::SFML::Update(m_window, frameTime);
 		}
 
-		m_currentScene->checkInput();
+		// Once per frame whatever the number of steps: the editor follows the mouse every frame
+		{
+			PROFILE_ZONE("checkInput");
+			m_currentScene->checkInput();
+		}
 
-		sf::Time dt = clock.restart();
-		ImGui::SFML::Update(m_window, dt);
-		m_currentScene->update(dt.asSeconds());
+		// Fixed rate simulation: the frame time is consumed in whole steps, the remainder is carried over
+		accumulator += frameTime;
+		int steps = 0;
+		while (accumulator >= step && steps < MAX_SIMULATION_STEPS)
+		{
+			{
+				PROFILE_ZONE("update");
+				m_currentScene->update(SIMULATION_STEP);	// not step.asSeconds(): rounded to microseconds
+			}
+			accumulator -= step;
+			++steps;
+		}
 
-		m_window.clear();
+		// Too far behind (hitch, breakpoint...): drop the time rather than running a burst of steps next frame
+		if (accumulator >= step)
+			accumulator = sf::microseconds(accumulator.asMicroseconds() % step.asMicroseconds());
 
-		m_currentScene->draw(m_window);
-		ImGui::SFML::Render(m_window);
+		{
+			PROFILE_ZONE("draw");
+			m_window.clear();
+
+			// Drawn between the last two simulation states
+			m_currentScene->draw(m_window, accumulator.asSeconds() / step.asSeconds());
+		}
+		{
+			PROFILE_ZONE("imgui render");
+			Profiler::drawImGui();
+			RenderStats::drawImGui();
+			ImGui::SFML::Render(m_window);
+		}
+		{
+			PROFILE_ZONE("display");	// waits for vsync
+			m_window.display();
+		}
 
-		m_window.display();
+		// Once a level is loaded, frames shouldn't allocate: the profiler zones tell where it happened
+		const std::uint64_t allocations = AllocationTracker::getThreadAllocations() - frameAllocations;
+		if (allocations > 0)
+			LOG_LIMITED(Debug, 1, "%llu heap allocations during the frame", (unsigned long long)allocations);
 	}
 
 	ImGui::SFML::Shutdown();
@@ -0,0 +1,334 @@
+#include "Scene/Simulation.hpp"
+#include "Entity/AnimationLibrary.hpp"
+#include "Constants.hpp"
+#include "Utility/Profiler.hpp"
+
+#include <iostream>
+#include <cassert>
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+Simulation::Simulation()
+	: m_map(m_tilesMgr)
+{
+	// Animations are plain data: no texture needed
+	m_playerAnimations = AnimationLibrary::load(ANIMATIONS_PATH + "player.txt");
+	m_enemyAnimations = AnimationLibrary::load(ANIMATIONS_PATH + "enemy.txt");
+}
+
+bool Simulation::loadLevel(const std::string& levelFilename, bool importText)
+{
+	// reset
+	destroyEntities();
+	m_map.clear();	// stops streaming: the streaming thread reads the tiles registry
+	m_tilesMgr.clearTiles();
+	m_tick = 0;
+
+	// Tiles
+	// Important: load tiles before map because map uses the tiles (obviously!)
+	m_tilesMgr.loadTiles(TEXTURES_PATH + "tilesData.json");	// Setting up pointers before creating map
+
+	// Map and entities: binary container if any, text files otherwise
+	bool mapLoaded;
+	auto levelFile = std::make_unique<LevelFile>();
+	if (!importText && levelFile->open(levelFilename + "/level.bin"))
+	{
+		// Every entity is spawned now, those outside the streamed area are frozen (see step())
+		for (const LevelEntity& entity : levelFile->getEntities())
+			spawnEntity(entity.type, entity.x, entity.y);
+		mapLoaded = m_map.stream(std::move(levelFile));
+
+		// The player is never frozen: its ground must be there for the first step, not a few frames later
+		if (m_world.isValid(m_player))
+			m_map.streamInAround(m_world.positions[getPlayer()]);
+	}
+	else
+	{
+		mapLoaded = m_map.load(levelFilename + "/map.txt");
+		loadEntities(levelFilename + "/entities.json");
+	}
+
+	if (!m_world.isValid(m_player))
+	{
+		std::cerr << "Level " << levelFilename << " has no player" << std::endl;
+		return false;
+	}
+	return mapLoaded;
+}
+
+void Simulation::applyInput(const PlayerInput& input)
+{
+	const std::size_t playerIndex = getPlayer();
+	Kinematics& player = m_world.kinematics[playerIndex];
+	if (input.right)
+	{
+		player.facing = Direction::Right;
+		m_world.setWalkingState(playerIndex, WalkingState::Beginning);
+	}
+	else if (input.left)
+	{
+		player.facing = Direction::Left;
+		m_world.setWalkingState(playerIndex, WalkingState::Beginning);
+	}
+	else
+		m_world.setWalkingState(playerIndex, WalkingState::End);
+
+
+	// Check for jump
+	if (input.jump)
+	{
+		m_world.setYState(playerIndex, YState::Jumping);
+		return;
+	}
+
+	// Check for ladder (single map query)
+	if (!m_map.touchingTile(m_world.hitboxes[playerIndex], Tile::Property::Ladder))
+		return;
+
+	if (input.up)
+	{
+		m_world.setYState(playerIndex, YState::Climbing);
+		player.climbingDirection = Direction::Up;
+	}
+	else if (input.down)
+	{
+		m_world.setYState(playerIndex, YState::Climbing);
+		player.climbingDirection = Direction::Down;
+	}
+	else
+		player.climbingDirection = Direction::None;
+}
+
+void Simulation::step(const PlayerInput& input, float dt)
+{
+	PROFILE_ZONE("Simulation::step");
+
+	// Drawing interpolates from the state before this step
+	m_world.storePreviousPositions();
+	applyInput(input);
+
+	const std::size_t player = getPlayer();
+
+	// Entities waiting for their chunk to be streamed in are frozen
+	for (std::size_t i = 0; i < m_world.size(); ++i)
+		m_world.active[i] = i == player || m_map.isActiveAt(m_world.positions[i]);
+
+	// Enemy collision: only overlapping pairs from the broadphase are visited
+	{
+		PROFILE_ZONE("contacts");
+		m_contacts.clear();
+		m_world.findOverlappingPairs(m_contacts);
+		for (const auto& [a, b] : m_contacts)
+		{
+			const bool aIsPlayer = m_world.kinds[a] == EntityKind::Player;
+			const std::size_t target = aIsPlayer ? a : b;
+			const std::size_t other = aIsPlayer ? b : a;
+			if (m_world.kinds[target] != EntityKind::Player || m_world.kinds[other] != EntityKind::Enemy || !m_world.active[other])
+				continue;
+
+			if (!m_world.healths[target].invincible && m_world.isAlive(target))
+			{
+				m_world.takeDamage(target, 20);
+				m_world.setInvincible(target, true, 1.f);
+			}
+		}
+	}
+
+	// internal entities update
+	{
+		PROFILE_ZONE("systems");
+		m_world.updateKinematics(dt);
+		m_world.updateHealth(dt);
+		m_world.updateAnimations(dt);
+	}
+
+	// external entities update: against the map
+	{
+		PROFILE_ZONE("moves");
+		updateClimbingState(player);	// no climbing for enemies
+		for (std::size_t i = 0; i < m_world.size(); ++i)
+		{
+			if (!m_world.active[i])
+				continue;
+
+			if (m_world.kinds[i] == EntityKind::Enemy)
+				moveEnemy(i);
+			else
+				moveEntity(i);
+		}
+	}
+
+	++m_tick;
+}
+
+void Simulation::updateStreaming(const sf::Vector2f& center)
+{
+	PROFILE_ZONE("Simulation::updateStreaming");
+	m_map.updateStreaming(center);
+}
+
+namespace
+{
+	// FNV-1a
+	void hashBytes(std::uint32_t& hash, const void* data, std::size_t size)
+	{
+		const auto* bytes = static_cast<const unsigned char*>(data);
+		for (std::size_t i = 0; i < size; ++i)
+			hash = (hash ^ bytes[i]) * 16777619u;
+	}
+
+	template <typename T>
+	void hashValue(std::uint32_t& hash, const T& value)
+	{
+		hashBytes(hash, &value, sizeof(value));	// fields one by one: no padding bytes
+	}
+}
+
+std::uint32_t Simulation::computeChecksum() const
+{
+	std::uint32_t hash = 2166136261u;
+	hashValue(hash, m_tick);
+	hashValue(hash, (std::uint64_t)m_world.size());
+	for (std::size_t i = 0; i < m_world.size(); ++i)
+	{
+		const Kinematics& k = m_world.kinematics[i];
+		hashValue(hash, m_world.kinds[i]);
+		hashValue(hash, m_world.positions[i].x);
+		hashValue(hash, m_world.positions[i].y);
+		hashValue(hash, k.velocity.x);
+		hashValue(hash, k.velocity.y);
+		hashValue(hash, k.walkingState);
+		hashValue(hash, k.yState);
+		hashValue(hash, k.facing);
+		hashValue(hash, m_world.healths[i].hp);
+	}
+	return hash;
+}
+
+void Simulation::saveKeyframe(Keyframe& keyframe) const
+{
+	keyframe.tick = m_tick;
+	keyframe.player = m_player;
+	m_world.save(keyframe.world);
+}
+
+void Simulation::restoreKeyframe(const Keyframe& keyframe)
+{
+	m_tick = keyframe.tick;
+	m_player = keyframe.player;
+	m_world.restore(keyframe.world);
+}
+
+void Simulation::destroyEntities()
+{
+	m_player = EntityHandle();
+	m_world.clear();
+}
+
+void Simulation::updateClimbingState(std::size_t entity)
+{
+	if (m_world.kinematics[entity].yState == YState::Climbing && !m_map.touchingTile(m_world.hitboxes[entity], Tile::Property::Ladder))
+		m_world.setYState(entity, YState::Falling);
+}
+
+void Simulation::loadEntities(const std::string& entitiesFilename)
+{
+	std::ifstream stream(entitiesFilename);
+	if (stream)
+	{
+		nlohmann::json data;
+		stream >> data;
+
+		// Loading the player
+		spawnEntity(LevelEntity::Type::Player, data["player"][0], data["player"][1]);
+
+		// Loading the entities
+		for (const auto& enemy : data["enemies"])
+			spawnEntity(LevelEntity::Type::Enemy, enemy[0], enemy[1]);
+	}
+	else
+	{
+		std::cerr << "Failed to open: " << entitiesFilename << std::endl;
+	}
+}
+
+EntityHandle Simulation::spawnEntity(LevelEntity::Type type, float x, float y)
+{
+	if (type == LevelEntity::Type::Player)
+	{
+		assert(!m_world.isValid(m_player));	// m_player should be initialized once per level loading
+		m_player = m_world.spawn(EntityKind::Player, { x, y }, m_playerAnimations, 400.f);
+		return m_player;
+	}
+	else if (type == LevelEntity::Type::Enemy)
+	{
+		const EntityHandle enemy = m_world.spawn(EntityKind::Enemy, { x, y }, m_enemyAnimations, 200.f);
+		m_world.setWalkingState(m_world.indexOf(enemy), WalkingState::Beginning);
+		return enemy;
+	}
+
+	std::cerr << "!!! Calling spawnEntity with type=" << (int)type << "!!!" << std::endl;
+	return EntityHandle();
+}
+
+bool Simulation::despawnEntity(EntityHandle entity)
+{
+	assert(entity != m_player);
+	return m_world.despawn(entity);
+}
+
+void Simulation::moveEntity(std::size_t entity, bool* xCollision)
+{
+	Box hitbox = m_world.hitboxes[entity];
+	const sf::Vector2f& movement = m_world.kinematics[entity].movement;
+
+	float dx = movement.x;
+	float dy = movement.y;
+
+	// Y checking: move up to the first solid row on the way
+	if (dy != 0.f)
+	{
+		const Map::Sweep sweep = m_map.sweepY(hitbox, dy, Tile::Property::Solid);
+		hitbox.y += dy * sweep.time;
+
+		const YState yState = m_world.kinematics[entity].yState;
+		if (sweep.normal.y < 0 && yState == YState::Falling)	// landed
+			m_world.setYState(entity, YState::Grounded);
+		else if (sweep.normal.y > 0 && yState == YState::Jumping)
+		{
+			//std::cout << "block ahead keeping from jumping higher" << std::endl;
+			m_world.setYState(entity, YState::Falling);
+		}
+	}
+
+	// X checking: move up to the first solid column on the way
+	if (dx != 0.f)
+	{
+		const Map::Sweep sweep = m_map.sweepX(hitbox, dx, Tile::Property::Solid);
+		hitbox.x += dx * sweep.time;
+
+		if (sweep.normal.x != 0 && xCollision)
+			*xCollision = true;
+
+		// Nothing right under the feet anymore
+		if (m_world.kinematics[entity].yState == YState::Grounded && m_map.sweepY(hitbox, 1.f, Tile::Property::Solid).normal.y == 0)
+		{
+			//std::cerr << "moving aside made the player fall" << std::endl;
+			m_world.setYState(entity, YState::Falling);
+		}
+	}
+
+	m_world.setPosition(entity, { hitbox.x, hitbox.y });
+}
+
+void Simulation::moveEnemy(std::size_t enemy)
+{
+	bool xCollision = false;
+	moveEntity(enemy, &xCollision);
+	if (xCollision)	// turn around
+	{
+		Direction& facing = m_world.kinematics[enemy].facing;
+		facing = (facing == Direction::Right) ? Direction::Left : Direction::Right;
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Scene/Map.hpp"
+#include "Scene/TilesManager.hpp"
+#include "Scene/LevelFile.hpp"
+#include "Entity/World.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** Player controls held during a simulation step, wherever they come from (keyboard, script, recording) **/
+struct PlayerInput
+{
+	bool left = false;
+	bool right = false;
+	bool jump = false;
+	bool up = false;	// climbing
+	bool down = false;
+
+	bool operator==(const PlayerInput& other) const
+	{
+		return left == other.left && right == other.right && jump == other.jump && up == other.up && down == other.down;
+	}
+	bool operator!=(const PlayerInput& other) const { return !(*this == other); }
+};
+
+/** Game logic of a level: map, entities and their rules. No window, no texture, no graphics context:
+ * runs the same inside GameScene and headless (servers, tests, benchmarks) **/
+class Simulation
+{
+public:
+	Simulation();
+	~Simulation() = default;
+
+	// Loads level.bin from the level directory, or map.txt + entities.json if there is none (or if importText)
+	bool loadLevel(const std::string& levelFilename, bool importText = false);
+
+	// One fixed step: applies input to the player then updates every entity
+	void step(const PlayerInput& input, float dt);
+	[[nodiscard]] std::uint64_t getTick() const { return m_tick; }	// steps since the level was loaded
+
+	// Streamed levels: chunks around center become resident, entities elsewhere are frozen
+	void updateStreaming(const sf::Vector2f& center);
+
+	// ----- Replays -----
+	// Hash of the state that must match between a recording and its playback: positions, velocities, states, hp
+	[[nodiscard]] std::uint32_t computeChecksum() const;
+
+	/** Entities state at a tick, to seek in a replay. The map isn't part of it: gameplay doesn't change it **/
+	struct Keyframe
+	{
+		std::uint64_t tick = 0;
+		EntityHandle player;
+		World::Snapshot world;
+	};
+	void saveKeyframe(Keyframe& keyframe) const;
+	void restoreKeyframe(const Keyframe& keyframe);
+
+	// ----- Entity management -----
+	void loadEntities(const std::string& entitiesFilename);
+	EntityHandle spawnEntity(LevelEntity::Type type, float x, float y);
+	bool despawnEntity(EntityHandle entity);	// not the player
+	void destroyEntities();
+	void moveEntity(std::size_t entity, bool* xCollision = nullptr);
+	void updateClimbingState(std::size_t entity);
+	void moveEnemy(std::size_t enemy);
+
+	[[nodiscard]] std::size_t getPlayer() const { return m_world.indexOf(m_player); }	// dense index of the player
+
+	Map& getMap() { return m_map; }
+	[[nodiscard]] const Map& getMap() const { return m_map; }
+	World& getWorld() { return m_world; }
+	[[nodiscard]] const World& getWorld() const { return m_world; }
+	TilesManager& getTilesManager() { return m_tilesMgr; }
+
+private:
+	void applyInput(const PlayerInput& input);
+
+	TilesManager m_tilesMgr;	// before m_map: the map refers to it
+	Map m_map;
+
+	// Entities storage
+	World m_world;
+	EntityHandle m_player;
+	std::shared_ptr<const AnimationSet> m_playerAnimations;	// shared by every spawn
+	std::shared_ptr<const AnimationSet> m_enemyAnimations;
+	std::vector<std::pair<std::size_t, std::size_t>> m_contacts;	// reused every step
+
+	std::uint64_t m_tick = 0;
+};
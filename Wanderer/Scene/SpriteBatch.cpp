@@ -0,0 +1,60 @@
+#include "Scene/SpriteBatch.hpp"
+#include "Scene/RenderStats.hpp"
+
+void SpriteBatch::clear()
+{
+	for (Batch& batch : m_batches)
+		batch.vertices.clear();
+}
+
+void SpriteBatch::add(const sf::Texture& texture, const sf::Vector2f& position, const sf::IntRect& textureRect)
+{
+	if (m_lastBatch >= m_batches.size() || m_batches[m_lastBatch].texture != &texture)
+	{
+		m_lastBatch = 0;
+		while (m_lastBatch < m_batches.size() && m_batches[m_lastBatch].texture != &texture)
+			++m_lastBatch;
+
+		if (m_lastBatch == m_batches.size())
+			m_batches.push_back({ &texture, {} });
+	}
+
+	std::vector<sf::Vertex>& vertices = m_batches[m_lastBatch].vertices;
+	const float w = static_cast<float>(textureRect.width);
+	const float h = static_cast<float>(textureRect.height);
+	const float u = static_cast<float>(textureRect.left);
+	const float v = static_cast<float>(textureRect.top);
+
+	vertices.emplace_back(position, sf::Vector2f(u, v));
+	vertices.emplace_back(sf::Vector2f(position.x + w, position.y), sf::Vector2f(u + w, v));
+	vertices.emplace_back(sf::Vector2f(position.x + w, position.y + h), sf::Vector2f(u + w, v + h));
+	vertices.emplace_back(sf::Vector2f(position.x, position.y + h), sf::Vector2f(u, v + h));
+}
+
+std::size_t SpriteBatch::getQuadCount() const
+{
+	std::size_t quads = 0;
+	for (const Batch& batch : m_batches)
+		quads += batch.vertices.size() / 4;
+	return quads;
+}
+
+std::size_t SpriteBatch::getBatchCount() const
+{
+	std::size_t batches = 0;
+	for (const Batch& batch : m_batches)
+		batches += batch.vertices.empty() ? 0 : 1;
+	return batches;
+}
+
+void SpriteBatch::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	for (const Batch& batch : m_batches)
+	{
+		if (batch.vertices.empty())
+			continue;
+
+		states.texture = batch.texture;
+		RenderStats::draw(target, batch.vertices.data(), batch.vertices.size(), sf::Quads, states);
+	}
+}
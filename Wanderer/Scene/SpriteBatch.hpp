@@ -0,0 +1,30 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+/** Collects textured quads and submits them with one draw call per texture.
+ *  Quads of a texture are drawn in the order they were added **/
+class SpriteBatch : public sf::Drawable
+{
+public:
+	SpriteBatch() = default;
+	~SpriteBatch() override = default;
+
+	void clear();	// keeps the vertex storage for the next frame
+	void add(const sf::Texture& texture, const sf::Vector2f& position, const sf::IntRect& textureRect);
+
+	[[nodiscard]] std::size_t getQuadCount() const;
+	[[nodiscard]] std::size_t getBatchCount() const;	// draw calls issued by draw()
+
+private:
+	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+	struct Batch
+	{
+		const sf::Texture* texture;
+		std::vector<sf::Vertex> vertices;	// 4 per quad
+	};
+	std::vector<Batch> m_batches;	// a handful of textures: searched linearly
+	std::size_t m_lastBatch = 0;	// consecutive adds usually share the texture
+};
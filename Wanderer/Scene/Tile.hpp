@@ -2,6 +2,7 @@
 
 #include <SFML/Graphics.hpp>
 #include <iostream>
+#include <cstdint>
 
 
 struct Tile {
@@ -12,6 +13,11 @@ struct Tile {
 		Solid,
 		Ladder
 	};
+	static constexpr int PROPERTY_COUNT = 3;	// keep in sync with Property
+
+	// Sets of properties, see Map::touchedProperties()
+	typedef std::uint32_t PropertyMask;
+	static constexpr PropertyMask bit(Property property) { return 1u << (unsigned)property; }
 
 	std::string name;		// Comprehensible name [optional]
 	char indexInFile;		// In-file representation
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Scene/TilesManager.hpp"
+#include "Constants.hpp"
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+typedef std::uint64_t ChunkKey;	// packed (chunkX, chunkY), see makeChunkKey()
+typedef std::uint16_t ChunkRow;	// one bit per cell of a chunk row
+static_assert(CHUNK_SIZEi <= (int)sizeof(ChunkRow) * 8, "ChunkRow can't hold a chunk row");
+
+/** Square block of CHUNK_SIZEi * CHUNK_SIZEi tiles. The map only stores chunks holding at least one non-default tile.
+ *  Plain data, no GPU resource: chunks are built by the simulation and the streaming thread, without graphics context **/
+struct TileChunk
+{
+	static constexpr std::int16_t NO_QUAD = -1;
+
+	explicit TileChunk(TileId defaultTile)
+	{
+		tiles.fill(defaultTile);
+		quads.fill(NO_QUAD);
+	}
+
+	TileId& at(int localX, int localY) { return tiles[localY * CHUNK_SIZEi + localX]; }
+	[[nodiscard]] TileId at(int localX, int localY) const { return tiles[localY * CHUNK_SIZEi + localX]; }
+
+	std::array<TileId, CHUNK_SIZEi * CHUNK_SIZEi> tiles;	// row-major
+	std::uint16_t occupied = 0;	// number of non-default tiles, the chunk is dropped when it reaches 0
+
+	// Collisions: one bitplane per Tile::Property, bit x of planes[p][y] is set if cell (x, y) has property p
+	std::array<std::array<ChunkRow, CHUNK_SIZEi>, Tile::PROPERTY_COUNT> planes{};
+
+	// Graphics: 4 vertices per drawn cell, in no particular order
+	std::array<std::int16_t, CHUNK_SIZEi * CHUNK_SIZEi> quads;	// cell's quad index in vertices, NO_QUAD if not drawn
+	std::vector<std::uint8_t> quadCells;	// cell owning each quad, to fix indexes on swap-removal
+	std::vector<sf::Vertex> vertices;
+	mutable bool bufferDirty = true;	// vertices changed since Map::draw() last uploaded them
+
+	// Streaming, see Map::updateStreaming()
+	std::uint32_t lastUsed = 0;	// streaming frame the chunk was last in range
+	bool pinned = false;		// edited in the map: never evicted
+};
+
+// Floor division: tile -1 belongs to chunk -1, not chunk 0
+inline int tileToChunk(int tile)
+{
+	return (tile >= 0 ? tile : tile - (CHUNK_SIZEi - 1)) / CHUNK_SIZEi;
+}
+
+inline int tileToLocal(int tile)
+{
+	return tile - tileToChunk(tile) * CHUNK_SIZEi;
+}
+
+inline ChunkKey makeChunkKey(int chunkX, int chunkY)
+{
+	return ((ChunkKey)(std::uint32_t)chunkX << 32) | (ChunkKey)(std::uint32_t)chunkY;
+}
+
+inline sf::Vector2i chunkFromKey(ChunkKey key)
+{
+	return { (int)(std::int32_t)(std::uint32_t)(key >> 32), (int)(std::int32_t)(std::uint32_t)key };
+}
@@ -4,11 +4,16 @@
 
 #include <nlohmann/json.hpp>
 #include <fstream>
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <list>
 
-typedef size_t TileId;
+typedef std::uint8_t TileId;	// compact: a chunk of 16*16 tiles fits in 256 bytes
 
 
+/** Tiles registry. Tiles are stored as flat per-field arrays indexed by TileId so that hot lookups
+ *  (property, texture coords, in-file index) are a single indexed load with no copy **/
 class TilesManager
 {
 public:
@@ -19,22 +24,35 @@ public:
 		{
 			nlohmann::json data;
 			stream >> data;
-			std::string usedIndexes;
 
 			// Browse tiles
 			for (auto& tileData : data["tiles"])
 			{
+				if (m_tiles.size() > std::numeric_limits<TileId>::max())
+				{
+					std::cerr << "Too many tiles, TileId can't hold more than " << m_tiles.size() << std::endl;
+					break;
+				}
+
+				const char currentIndex = (char)((std::string)tileData["index"]).front();
+				if (m_idFromIndex[(unsigned char)currentIndex] != NO_TILE)
+				{
+					std::cerr << "Index " << currentIndex << " was already used!" << std::endl;
+					continue;
+				}
+
 				m_tiles.push_back({
 					(std::string)tileData["name"],
-					(char)((std::string)tileData["index"]).front(),
+					currentIndex,
 					sf::Vector2f(tileData["texCoords"][0], tileData["texCoords"][1]),
 					parseTileProperty(tileData["property"])
 				});
 
-				char currentIndex = m_tiles.back().indexInFile;
-				if (usedIndexes.find(currentIndex), usedIndexes.cbegin(), usedIndexes.cend() != usedIndexes.cend())
-					std::cerr << "Index " << currentIndex << " was already used!" << std::endl;
-				usedIndexes += currentIndex;
+				const Tile& tile = m_tiles.back();
+				m_idFromIndex[(unsigned char)currentIndex] = (std::int16_t)(m_tiles.size() - 1);
+				m_properties.push_back(tile.property);
+				m_texCoords.push_back(tile.texCoords);
+				m_indexes.push_back(tile.indexInFile);
 			}
 
 			// '.' character usually represents void
@@ -47,31 +65,33 @@ public:
 	void clearTiles()
 	{
 		m_tiles.clear();
+		m_properties.clear();
+		m_texCoords.clear();
+		m_indexes.clear();
+		m_idFromIndex.fill(NO_TILE);
+		m_defaultTile = TileId();	// as constructed: the next loadTiles() registers the default again
 	}
 
 
-	[[nodiscard]] Tile getTileFromId(TileId id) const { return m_tiles[id]; }
-	[[nodiscard]] Tile::Property getTilePropertyFromId(TileId id) const {
-		return getTileFromId(id).property;
-	}
-	[[nodiscard]] const sf::Vector2<float> getTileTexCoordsFromId(TileId id) const {
-		return getTileFromId(id).texCoords;
-	}
+	[[nodiscard]] const Tile& getTileFromId(TileId id) const { return m_tiles[id]; }
+	[[nodiscard]] Tile::Property getTilePropertyFromId(TileId id) const { return m_properties[id]; }
+	[[nodiscard]] const sf::Vector2f& getTileTexCoordsFromId(TileId id) const { return m_texCoords[id]; }
+	[[nodiscard]] char getTileIndexFromId(TileId id) const { return m_indexes[id]; }
 
 	[[nodiscard]] TileId getTileFromIndex(char index) const
 	{
-		for (size_t i = 0; i < m_tiles.size(); ++i)
-		{
-			if (m_tiles[i].indexInFile == index)
-				return (TileId)i;
-		}
+		const std::int16_t id = m_idFromIndex[(unsigned char)index];
+		if (id != NO_TILE)
+			return (TileId)id;
 
 		std::cerr << "Critical error: can't get tile from index(" << index << ")\n" << std::flush;
 		return (TileId)0;
 	}
+	[[nodiscard]] bool isKnownIndex(char index) const { return m_idFromIndex[(unsigned char)index] != NO_TILE; }
 	[[nodiscard]] TileId getDefaultTile() const { return m_defaultTile; }
 
-	[[nodiscard]] std::vector<Tile> getTiles() const { return m_tiles; }
+	[[nodiscard]] const std::vector<Tile>& getTiles() const { return m_tiles; }
+	[[nodiscard]] std::size_t getTileCount() const { return m_tiles.size(); }
 
 	static Tile::Property parseTileProperty(const std::string& str) {
 		if      (str == "Void")   return Tile::Property::Void;
@@ -84,6 +104,24 @@ public:
 	}
 
 private:
-	std::vector<Tile> m_tiles;
-	TileId m_defaultTile = 0;	// See loadTiles()
+	static constexpr std::int16_t NO_TILE = -1;
+
+	std::vector<Tile> m_tiles;	// full descriptions, for the editor
+
+	// Hot data, indexed by TileId
+	std::vector<Tile::Property> m_properties;
+	std::vector<sf::Vector2f> m_texCoords;
+	std::vector<char> m_indexes;
+
+	// In-file char to TileId, NO_TILE if unused
+	std::array<std::int16_t, 256> m_idFromIndex = makeEmptyIndexTable();
+
+	TileId m_defaultTile = 0;	// See loadTiles(). Every TileId value is a valid id: no NO_TILE sentinel fits here
+
+	static std::array<std::int16_t, 256> makeEmptyIndexTable()
+	{
+		std::array<std::int16_t, 256> table{};
+		table.fill(NO_TILE);
+		return table;
+	}
 };
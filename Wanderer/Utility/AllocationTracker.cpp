@@ -0,0 +1,99 @@
+#include "Utility/AllocationTracker.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	// Plain integers: no constructor to run on first use, which could allocate
+	thread_local std::uint64_t t_allocations = 0;
+	thread_local std::uint64_t t_frees = 0;
+	thread_local std::uint64_t t_bytes = 0;
+
+	std::atomic<std::uint64_t> s_allocations{ 0 };
+	std::atomic<std::uint64_t> s_frees{ 0 };
+	std::atomic<std::uint64_t> s_bytes{ 0 };
+}
+
+AllocationTracker::Counters AllocationTracker::getThreadCounters()
+{
+	return { t_allocations, t_frees, t_bytes };
+}
+
+AllocationTracker::Counters AllocationTracker::getTotalCounters()
+{
+	return {
+		s_allocations.load(std::memory_order_relaxed),
+		s_frees.load(std::memory_order_relaxed),
+		s_bytes.load(std::memory_order_relaxed)
+	};
+}
+
+std::uint64_t AllocationTracker::getThreadAllocations()
+{
+	return t_allocations;
+}
+
+#ifndef WANDERER_NO_ALLOCATION_TRACKING
+
+// Replacements of the global operators: every other form (aligned ones aside) ends up in these
+namespace
+{
+	void* allocate(std::size_t size)
+	{
+		if (size == 0)
+			size = 1;	// distinct pointers for empty objects
+
+		void* p;
+		while (!(p = std::malloc(size)))
+		{
+			const std::new_handler handler = std::get_new_handler();
+			if (!handler)
+				throw std::bad_alloc();
+			handler();
+		}
+
+		++t_allocations;
+		t_bytes += size;
+		s_allocations.fetch_add(1, std::memory_order_relaxed);
+		s_bytes.fetch_add(size, std::memory_order_relaxed);
+		return p;
+	}
+
+	void* allocateNoThrow(std::size_t size) noexcept
+	{
+		try
+		{
+			return allocate(size);
+		}
+		catch (const std::bad_alloc&)
+		{
+			return nullptr;
+		}
+	}
+
+	void release(void* p) noexcept
+	{
+		if (!p)
+			return;
+
+		++t_frees;
+		s_frees.fetch_add(1, std::memory_order_relaxed);
+		std::free(p);
+	}
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+/** Counts the heap allocations made through operator new: containers, strings, shared_ptr... of the whole program.
+ *  Counters are kept per thread (one increment per allocation) and for the whole process. malloc() isn't tracked,
+ *  neither is ImGui which uses it. Profiler zones record the allocations made while they were open.
+ *  Define WANDERER_NO_ALLOCATION_TRACKING to keep the default operator new: every counter then stays at 0 **/
+class AllocationTracker
+{
+public:
+	struct Counters
+	{
+		std::uint64_t allocations = 0;
+		std::uint64_t frees = 0;
+		std::uint64_t bytes = 0;	// allocated: operator delete isn't always given the size
+	};
+
+	[[nodiscard]] static Counters getThreadCounters();	// calling thread, since it started
+	[[nodiscard]] static Counters getTotalCounters();	// every thread: allocations - frees blocks are alive
+	[[nodiscard]] static std::uint64_t getThreadAllocations();	// cheapest, for zones
+	[[nodiscard]] static constexpr bool isEnabled()
+	{
+#ifdef WANDERER_NO_ALLOCATION_TRACKING
+		return false;
+#else
+		return true;
+#endif
+	}
+};
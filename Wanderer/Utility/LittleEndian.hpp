@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Byte-wise little-endian access for binary files: no alignment nor host endianness assumption
+
+inline std::uint16_t readU16(const unsigned char* p) { return (std::uint16_t)(p[0] | (p[1] << 8)); }
+inline std::uint32_t readU32(const unsigned char* p)
+{
+	return (std::uint32_t)p[0] | ((std::uint32_t)p[1] << 8) | ((std::uint32_t)p[2] << 16) | ((std::uint32_t)p[3] << 24);
+}
+inline float readF32(const unsigned char* p)
+{
+	std::uint32_t bits = readU32(p);
+	float f;
+	std::memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+inline void writeU16(std::vector<unsigned char>& out, std::uint16_t v)
+{
+	out.push_back((unsigned char)(v & 0xFF));
+	out.push_back((unsigned char)(v >> 8));
+}
+inline void writeU32(std::vector<unsigned char>& out, std::uint32_t v)
+{
+	for (int i = 0; i < 4; ++i)
+		out.push_back((unsigned char)((v >> (8 * i)) & 0xFF));
+}
+inline void writeF32(std::vector<unsigned char>& out, float f)
+{
+	std::uint32_t bits;
+	std::memcpy(&bits, &f, sizeof(f));
+	writeU32(out, bits);
+}
@@ -0,0 +1,225 @@
+#include "Utility/Logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::atomic<bool> Logger::s_running{ false };
+std::atomic<std::uint64_t> Logger::s_dropped{ 0 };
+
+struct Logger::ThreadBuffer
+{
+	std::array<Message, RING_SIZE> messages;
+	std::atomic<std::uint64_t> written{ 0 };	// by the owner thread
+	std::atomic<std::uint64_t> read{ 0 };		// by the drain thread
+};
+
+namespace
+{
+	const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+	std::int64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+	}
+
+	const char* levelName(LogLevel level)
+	{
+		static const char* names[] = { "TRACE", "DEBUG", "INFO ", "WARN ", "ERROR" };
+		return names[static_cast<std::size_t>(level)];
+	}
+
+	const char* baseName(const char* path)
+	{
+		const char* name = path;
+		for (const char* c = path; *c; ++c)
+			if (*c == '/' || *c == '\\')
+				name = c + 1;
+		return name;
+	}
+
+	// Drain thread state
+	std::mutex s_mutex;		// buffers list, wake up
+	std::condition_variable s_wakeUp;
+	bool s_stop = false;
+	std::thread s_thread;
+	std::ofstream s_file;
+}
+
+std::vector<std::unique_ptr<Logger::ThreadBuffer>>& Logger::getBuffers()
+{
+	static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	return buffers;
+}
+
+Logger::ThreadBuffer& Logger::getThreadBuffer()
+{
+	thread_local ThreadBuffer* buffer = nullptr;
+	if (!buffer)
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		getBuffers().push_back(std::make_unique<ThreadBuffer>());
+		buffer = getBuffers().back().get();
+	}
+	return *buffer;
+}
+
+bool Logger::start(const std::string& filename)
+{
+	if (s_running.load())
+		return true;
+
+	s_file.open(filename);
+	if (!s_file)
+	{
+		std::cerr << "Logger: can't create " << filename << std::endl;
+		return false;
+	}
+
+	s_stop = false;
+	s_thread = std::thread(&Logger::run);
+	s_running.store(true);
+	return true;
+}
+
+void Logger::stop()
+{
+	if (!s_running.exchange(false))
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		s_stop = true;
+	}
+	s_wakeUp.notify_one();
+	s_thread.join();
+
+	drain();	// written between the last drain and s_running going false
+	if (s_dropped.load() > 0)
+		s_file << s_dropped.load() << " messages dropped: a log buffer was full\n";
+	s_file.close();
+}
+
+void Logger::write(LogLevel level, const char* file, int line, const char* format, ...)
+{
+	std::va_list args;
+	va_start(args, format);
+	writeV(level, file, line, format, args);
+	va_end(args);
+}
+
+void Logger::writeV(LogLevel level, const char* file, int line, const char* format, std::va_list args)
+{
+	const std::int64_t time = now();
+	if (!s_running.load(std::memory_order_acquire))
+	{
+		char text[MESSAGE_SIZE];
+		std::vsnprintf(text, sizeof(text), format, args);
+		std::cerr << levelName(level) << ' ' << baseName(file) << ':' << line << ' ' << text << std::endl;
+		return;
+	}
+
+	// Single writer: the slot is filled before the new count is published
+	ThreadBuffer& buffer = getThreadBuffer();
+	const std::uint64_t written = buffer.written.load(std::memory_order_relaxed);
+	if (written - buffer.read.load(std::memory_order_acquire) == RING_SIZE)
+	{
+		s_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	Message& message = buffer.messages[written & (RING_SIZE - 1)];
+	message.time = time;
+	message.level = level;
+	message.file = file;
+	message.line = line;
+	std::vsnprintf(message.text, sizeof(message.text), format, args);
+	buffer.written.store(written + 1, std::memory_order_release);
+}
+
+bool Logger::RateLimit::allow(std::uint32_t perSecond, std::uint32_t& suppressed)
+{
+	const std::int64_t time = now();
+	suppressed = 0;
+
+	// New one second window: what was suppressed in the previous one is reported once
+	std::int64_t windowStart = m_windowStart.load(std::memory_order_relaxed);
+	if (time - windowStart >= 1000000000 && m_windowStart.compare_exchange_strong(windowStart, time))
+	{
+		suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+		m_count.store(0, std::memory_order_relaxed);
+	}
+
+	if (m_count.fetch_add(1, std::memory_order_relaxed) < perSecond)
+		return true;
+
+	m_suppressed.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+void Logger::writeLimited(RateLimit& limit, std::uint32_t perSecond, LogLevel level, const char* file, int line, const char* format, ...)
+{
+	std::uint32_t suppressed;
+	const bool allowed = limit.allow(perSecond, suppressed);
+	if (suppressed > 0)
+		write(level, file, line, "(%u similar messages suppressed)", suppressed);
+	if (!allowed)
+		return;
+
+	std::va_list args;
+	va_start(args, format);
+	writeV(level, file, line, format, args);
+	va_end(args);
+}
+
+void Logger::run()
+{
+	std::unique_lock<std::mutex> lock(s_mutex);
+	while (!s_stop)
+	{
+		// Producers never notify: waking up now and then is cheaper than a lock per message
+		s_wakeUp.wait_for(lock, std::chrono::milliseconds(20));
+		lock.unlock();
+		drain();
+		lock.lock();
+	}
+}
+
+void Logger::drain()
+{
+	// Messages of every thread, in time order
+	static std::vector<Message> pending;
+	pending.clear();
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		for (const auto& buffer : getBuffers())
+		{
+			const std::uint64_t read = buffer->read.load(std::memory_order_relaxed);
+			const std::uint64_t written = buffer->written.load(std::memory_order_acquire);
+			for (std::uint64_t i = read; i < written; ++i)
+				pending.push_back(buffer->messages[i & (RING_SIZE - 1)]);
+			buffer->read.store(written, std::memory_order_release);
+		}
+	}
+	if (pending.empty())
+		return;
+
+	std::stable_sort(pending.begin(), pending.end(), [](const Message& lhs, const Message& rhs) { return lhs.time < rhs.time; });
+
+	char prefix[64];
+	for (const Message& message : pending)
+	{
+		std::snprintf(prefix, sizeof(prefix), "[%10.6f] %s ", (double)message.time * 1e-9, levelName(message.level));
+		s_file << prefix << baseName(message.file) << ':' << message.line << ' ' << message.text << '\n';
+	}
+	s_file.flush();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class LogLevel : std::uint8_t
+{
+	Trace = 0,
+	Debug,
+	Info,
+	Warning,
+	Error
+};
+
+// Messages below this level are compiled out. 0: Trace ... 4: Error
+#ifndef WANDERER_LOG_LEVEL
+#define WANDERER_LOG_LEVEL 1
+#endif
+
+/** Asynchronous logger. Each thread formats its messages into its own ring buffer (single writer, no lock);
+ * a background thread drains every ring to the log file. A full ring drops messages rather than blocking the frame.
+ * Before start() and after stop(), messages are written synchronously to std::cerr **/
+class Logger
+{
+public:
+	static constexpr std::size_t RING_SIZE = 1024;	// pending messages per thread, power of 2
+	static constexpr std::size_t MESSAGE_SIZE = 200;	// longer messages are truncated
+
+	static bool start(const std::string& filename);
+	static void stop();	// drains what is left
+	[[nodiscard]] static std::uint64_t getDroppedCount() { return s_dropped.load(std::memory_order_relaxed); }
+
+	static void write(LogLevel level, const char* file, int line, const char* format, ...);
+	static void writeV(LogLevel level, const char* file, int line, const char* format, std::va_list args);
+
+	/** At most perSecond messages per second from one call site, see LOG_LIMITED **/
+	class RateLimit
+	{
+	public:
+		bool allow(std::uint32_t perSecond, std::uint32_t& suppressed);	// suppressed: messages dropped in the previous window
+
+	private:
+		std::atomic<std::int64_t> m_windowStart{ 0 };
+		std::atomic<std::uint32_t> m_count{ 0 };
+		std::atomic<std::uint32_t> m_suppressed{ 0 };
+	};
+
+	static void writeLimited(RateLimit& limit, std::uint32_t perSecond, LogLevel level, const char* file, int line, const char* format, ...);
+
+private:
+	struct Message
+	{
+		std::int64_t time;	// ns since the logger started
+		LogLevel level;
+		const char* file;
+		int line;
+		char text[MESSAGE_SIZE];
+	};
+	struct ThreadBuffer;
+
+	static ThreadBuffer& getThreadBuffer();
+	static std::vector<std::unique_ptr<ThreadBuffer>>& getBuffers();	// never freed: a thread may log until the very end
+	static void run();	// drain thread
+	static void drain();
+
+	static std::atomic<bool> s_running;
+	static std::atomic<std::uint64_t> s_dropped;
+};
+
+#define LOG_ENABLED(level) (static_cast<int>(LogLevel::level) >= WANDERER_LOG_LEVEL)
+
+// printf-like: LOG(Info, "%d chunks", count);
+#define LOG(level, ...) \
+	do { if constexpr (LOG_ENABLED(level)) Logger::write(LogLevel::level, __FILE__, __LINE__, __VA_ARGS__); } while (0)
+
+// Rate limited per call site, for messages that may fire every frame
+#define LOG_LIMITED(level, perSecond, ...) \
+	do { if constexpr (LOG_ENABLED(level)) { static Logger::RateLimit logRateLimit; \
+		Logger::writeLimited(logRateLimit, perSecond, LogLevel::level, __FILE__, __LINE__, __VA_ARGS__); } } while (0)
@@ -0,0 +1,114 @@
+#include "Utility/MappedFile.hpp"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filename)
+{
+	close();
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		std::cerr << "MappedFile: can't map " << filename << std::endl;
+		CloseHandle(file);
+		return false;
+	}
+
+	m_data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!m_data)
+	{
+		std::cerr << "MappedFile: can't view " << filename << std::endl;
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_size = static_cast<std::size_t>(size.QuadPart);
+	m_fileHandle = file;
+	m_mappingHandle = mapping;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data)
+		UnmapViewOfFile(m_data);
+	if (m_mappingHandle)
+		CloseHandle(m_mappingHandle);
+	if (m_fileHandle)
+		CloseHandle(m_fileHandle);
+
+	m_data = nullptr;
+	m_size = 0;
+	m_mappingHandle = m_fileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filename)
+{
+	close();
+
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st{};
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	void* data = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);	// the mapping keeps the file alive
+	if (data == MAP_FAILED)
+	{
+		std::cerr << "MappedFile: can't map " << filename << std::endl;
+		return false;
+	}
+
+	m_data = static_cast<const unsigned char*>(data);
+	m_size = static_cast<std::size_t>(st.st_size);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data)
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+
+	m_data = nullptr;
+	m_size = 0;
+}
+
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/** Read-only memory mapping of a whole file (mmap, or MapViewOfFile on Windows) **/
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& filename);
+	void close();
+
+	[[nodiscard]] bool isOpen() const { return m_data != nullptr; }
+	[[nodiscard]] const unsigned char* data() const { return m_data; }
+	[[nodiscard]] std::size_t size() const { return m_size; }
+
+private:
+	const unsigned char* m_data = nullptr;
+	std::size_t m_size = 0;
+
+#ifdef _WIN32
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,169 @@
+#include "Utility/Profiler.hpp"
+#include "Utility/AllocationTracker.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+std::atomic<bool> Profiler::s_enabled{ true };
+std::mutex Profiler::s_buffersMutex;
+std::array<std::int64_t, Profiler::FRAME_HISTORY + 1> Profiler::s_frameStarts{};
+std::array<std::uint64_t, Profiler::FRAME_HISTORY + 1> Profiler::s_frameAllocations{};
+std::uint64_t Profiler::s_frameCount = 0;
+
+namespace
+{
+	const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+}
+
+std::int64_t Profiler::now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>>& Profiler::getBuffers()
+{
+	static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	return buffers;
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+{
+	thread_local ThreadBuffer* buffer = nullptr;
+	if (!buffer)
+	{
+		std::lock_guard<std::mutex> lock(s_buffersMutex);
+		getBuffers().push_back(std::make_unique<ThreadBuffer>());
+		buffer = getBuffers().back().get();
+		buffer->id = (std::uint32_t)getBuffers().size();
+	}
+	return *buffer;
+}
+
+void Profiler::setThreadName(const char* name)
+{
+	getThreadBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+void Profiler::beginFrame()
+{
+	s_frameStarts[s_frameCount % s_frameStarts.size()] = now();
+	s_frameAllocations[s_frameCount % s_frameAllocations.size()] = AllocationTracker::getThreadAllocations();
+	++s_frameCount;
+}
+
+Profiler::Scope::Scope(const char* name)
+	: m_name(isEnabled() ? name : nullptr)
+{
+	if (!m_name)
+		return;
+
+	m_buffer = &getThreadBuffer();
+	++m_buffer->depth;
+	m_allocations = AllocationTracker::getThreadAllocations();
+	m_start = now();
+}
+
+Profiler::Scope::~Scope()
+{
+	if (!m_name)
+		return;
+
+	const std::int64_t end = now();
+	const std::uint32_t allocations = (std::uint32_t)(AllocationTracker::getThreadAllocations() - m_allocations);
+	ThreadBuffer& buffer = *m_buffer;
+	--buffer.depth;
+
+	// Single writer: odd sequence while the slot is filled, then the new count is published
+	const std::uint64_t written = buffer.written.load(std::memory_order_relaxed);
+	Slot& slot = buffer.zones[written & (RING_SIZE - 1)];
+	const std::uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+	slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);	// readers seeing the new fields see the odd sequence
+
+	slot.name.store(m_name, std::memory_order_relaxed);
+	slot.start.store(m_start, std::memory_order_relaxed);
+	slot.end.store(end, std::memory_order_relaxed);
+	slot.depth.store(buffer.depth, std::memory_order_relaxed);
+	slot.allocations.store(allocations, std::memory_order_relaxed);
+
+	slot.sequence.store(sequence + 2, std::memory_order_release);
+	buffer.written.store(written + 1, std::memory_order_release);
+}
+
+void Profiler::snapshot(const ThreadBuffer& buffer, std::vector<Zone>& zones, std::int64_t after)
+{
+	zones.clear();
+	const std::uint64_t end = buffer.written.load(std::memory_order_acquire);
+	const std::uint64_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+	for (std::uint64_t i = end; i > begin; --i)
+	{
+		// Zone i - 1 is the (i - 1) / RING_SIZE + 1-th write to its slot
+		const Slot& slot = buffer.zones[(i - 1) & (RING_SIZE - 1)];
+		const std::uint64_t expected = 2 * ((i - 1) / RING_SIZE + 1);
+		if (slot.sequence.load(std::memory_order_acquire) != expected)
+			break;	// overwritten since `end` was read, or being: so are the older ones
+
+		const Zone zone{
+			slot.name.load(std::memory_order_relaxed),
+			slot.start.load(std::memory_order_relaxed),
+			slot.end.load(std::memory_order_relaxed),
+			slot.depth.load(std::memory_order_relaxed),
+			slot.allocations.load(std::memory_order_relaxed)
+		};
+		std::atomic_thread_fence(std::memory_order_acquire);	// the copy is done before the sequence is read again
+		if (slot.sequence.load(std::memory_order_relaxed) != expected)
+			break;	// overwritten during the copy
+
+		if (zone.end <= after)
+			break;	// older zones ended even sooner
+		zones.push_back(zone);
+	}
+}
+
+bool Profiler::exportChromeTrace(const std::string& filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cerr << "Profiler: can't create " << filename << std::endl;
+		return false;
+	}
+
+	// Trace event format: complete events ("X"), timestamps in microseconds
+	file.precision(3);
+	file << std::fixed << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	std::vector<Zone> zones;
+	std::size_t count = 0;
+
+	std::lock_guard<std::mutex> lock(s_buffersMutex);
+	for (const auto& buffer : getBuffers())
+	{
+		file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+			 << ",\"args\":{\"name\":\"" << buffer->name.load(std::memory_order_relaxed) << "\"}}";
+		first = false;
+
+		snapshot(*buffer, zones);
+		for (const Zone& zone : zones)
+		{
+			file << ",\n{\"name\":\"" << zone.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+				 << ",\"ts\":" << (double)zone.start * 1e-3 << ",\"dur\":" << (double)(zone.end - zone.start) * 1e-3;
+			if (zone.allocations > 0)
+				file << ",\"args\":{\"allocations\":" << zone.allocations << '}';
+			file << '}';
+		}
+		count += zones.size();
+	}
+	file << "\n]}\n";
+
+	if (!file)
+	{
+		std::cerr << "Profiler: can't write " << filename << std::endl;
+		return false;
+	}
+	std::cerr << "Profiler: " << count << " zones exported to " << filename << std::endl;
+	return true;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** Hierarchical frame profiler. PROFILE_ZONE("name") times the enclosing scope; zones nest.
+ *
+ * Each thread writes its closed zones to its own ring buffer (single writer, no lock): a zone costs two clock
+ * reads and a few relaxed stores. Readers (ImGui view, trace export) copy the rings while they are written:
+ * every slot is a seqlock, a zone is returned only if its slot held that very zone before and after the copy,
+ * so readers never see a torn or recycled zone, they miss the ones overwritten meanwhile.
+ * Names must be string literals: only the pointer is stored. Define WANDERER_NO_PROFILER to compile zones out **/
+class Profiler
+{
+	struct ThreadBuffer;
+
+public:
+	static constexpr std::size_t RING_SIZE = 1 << 16;	// zones kept per thread, power of 2
+	static constexpr std::size_t FRAME_HISTORY = 240;	// frames shown by drawImGui()
+
+	struct Zone
+	{
+		const char* name;
+		std::int64_t start;		// ns since the profiler started
+		std::int64_t end;
+		std::uint32_t depth;	// 0: outermost zone of its thread
+		std::uint32_t allocations;	// heap allocations while open, nested zones included (see AllocationTracker)
+	};
+
+	// Main thread, once per frame before anything else
+	static void beginFrame();
+	static void setThreadName(const char* name);	// shown in the view and the trace, literal only
+
+	static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+	[[nodiscard]] static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+	[[nodiscard]] static std::int64_t now();
+
+	static void drawImGui();	// live view of the last FRAME_HISTORY frames, see ProfilerView.cpp
+	static bool exportChromeTrace(const std::string& filename);	// chrome://tracing and Perfetto JSON
+
+	/** RAII zone, see PROFILE_ZONE **/
+	class Scope
+	{
+	public:
+		explicit Scope(const char* name);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* m_name;	// nullptr: the profiler was disabled when the zone opened
+		ThreadBuffer* m_buffer = nullptr;
+		std::int64_t m_start = 0;
+		std::uint64_t m_allocations = 0;	// thread count when the zone opened
+	};
+
+private:
+	// Ring slot. Fields are atomics so that copying a slot being written is not a data race (relaxed: plain moves),
+	// the sequence tells whether the copy is whole: 2 * writes to the slot, odd while a write is in progress
+	struct Slot
+	{
+		std::atomic<std::uint64_t> sequence{ 0 };
+		std::atomic<const char*> name{ nullptr };
+		std::atomic<std::int64_t> start{ 0 };
+		std::atomic<std::int64_t> end{ 0 };
+		std::atomic<std::uint32_t> depth{ 0 };
+		std::atomic<std::uint32_t> allocations{ 0 };
+	};
+
+	struct ThreadBuffer
+	{
+		std::uint32_t id = 0;
+		std::atomic<const char*> name{ "thread" };	// read by the view and the export
+		std::uint32_t depth = 0;	// zones currently open, owner thread only
+		std::vector<Slot> zones = std::vector<Slot>(RING_SIZE);	// by end time: zones are written when they close
+		std::atomic<std::uint64_t> written{ 0 };	// zones ever written, the ring holds the last RING_SIZE
+	};
+
+	static ThreadBuffer& getThreadBuffer();
+	static std::vector<std::unique_ptr<ThreadBuffer>>& getBuffers();	// never freed: zones of finished threads stay readable
+
+	// Zones still in the ring ending after `after`, newest first. Safe while the owner thread writes
+	static void snapshot(const ThreadBuffer& buffer, std::vector<Zone>& zones, std::int64_t after = -1);
+
+	static std::atomic<bool> s_enabled;
+	static std::mutex s_buffersMutex;
+
+	// Main thread only
+	static std::array<std::int64_t, FRAME_HISTORY + 1> s_frameStarts;	// ring, +1: the frame in progress
+	static std::array<std::uint64_t, FRAME_HISTORY + 1> s_frameAllocations;	// main thread count at each frame start
+	static std::uint64_t s_frameCount;
+};
+
+#ifndef WANDERER_NO_PROFILER
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name) Profiler::Scope PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
@@ -0,0 +1,97 @@
+#include "Utility/Profiler.hpp"
+#include "Utility/AllocationTracker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+
+#include <imgui.h>
+
+// Kept apart from Profiler.cpp: targets without imgui (headless, benchmark) still get the zones
+
+void Profiler::drawImGui()
+{
+	if (!ImGui::Begin("Profiler"))
+	{
+		ImGui::End();
+		return;
+	}
+
+	bool enabled = isEnabled();
+	if (ImGui::Checkbox("Enabled", &enabled))
+		setEnabled(enabled);
+	ImGui::SameLine();
+	if (ImGui::Button("Export trace (F9)"))
+		exportChromeTrace("profile.json");
+
+	// Durations of the complete frames, oldest first
+	const std::size_t complete = (std::size_t)std::min<std::uint64_t>(s_frameCount > 0 ? s_frameCount - 1 : 0, FRAME_HISTORY);
+	if (complete == 0)
+	{
+		ImGui::End();
+		return;
+	}
+
+	std::array<float, FRAME_HISTORY> frameTimes{};
+	std::array<float, FRAME_HISTORY> frameAllocations{};
+	for (std::size_t i = 0; i < complete; ++i)
+	{
+		const std::uint64_t frame = s_frameCount - 1 - complete + i;
+		const std::int64_t start = s_frameStarts[frame % s_frameStarts.size()];
+		const std::int64_t end = s_frameStarts[(frame + 1) % s_frameStarts.size()];
+		frameTimes[i] = (float)(end - start) * 1e-6f;
+		frameAllocations[i] = (float)(s_frameAllocations[(frame + 1) % s_frameAllocations.size()] - s_frameAllocations[frame % s_frameAllocations.size()]);
+	}
+	ImGui::PlotHistogram("Frames (ms)", frameTimes.data(), (int)complete, 0, nullptr, 0.f, 50.f, ImVec2(0, 60));
+
+	// Main thread: the steady state should stay flat at 0
+	if (AllocationTracker::isEnabled())
+	{
+		const AllocationTracker::Counters total = AllocationTracker::getTotalCounters();
+		ImGui::PlotHistogram("Allocations", frameAllocations.data(), (int)complete, 0, nullptr, 0.f, FLT_MAX, ImVec2(0, 40));
+		ImGui::Text("Heap: %llu live blocks, %llu allocations since start",
+			(unsigned long long)(total.allocations - total.frees), (unsigned long long)total.allocations);
+	}
+	else
+		ImGui::Text("Allocation tracking compiled out");
+
+	// Zones of one frame, 0 being the last complete one
+	static int framesBack = 0;
+	framesBack = std::min(framesBack, (int)complete - 1);
+	ImGui::SliderInt("Frames back", &framesBack, 0, (int)complete - 1);
+	const std::uint64_t frame = s_frameCount - 2 - (std::uint64_t)framesBack;
+	const std::int64_t frameStart = s_frameStarts[frame % s_frameStarts.size()];
+	const std::int64_t frameEnd = s_frameStarts[(frame + 1) % s_frameStarts.size()];
+	const std::uint64_t allocations = s_frameAllocations[(frame + 1) % s_frameAllocations.size()] - s_frameAllocations[frame % s_frameAllocations.size()];
+	ImGui::Text("Frame %llu: %.3f ms, %llu allocations", (unsigned long long)frame, (double)(frameEnd - frameStart) * 1e-6, (unsigned long long)allocations);
+
+	static std::vector<Zone> s_viewZones;	// reused
+	std::lock_guard<std::mutex> lock(s_buffersMutex);
+	for (const auto& buffer : getBuffers())
+	{
+		if (!ImGui::TreeNode(buffer.get(), "%s (%u)", buffer->name.load(std::memory_order_relaxed), buffer->id))
+			continue;
+
+		snapshot(*buffer, s_viewZones, frameStart);
+		auto outside = [=](const Zone& zone) { return zone.start >= frameEnd; };
+		s_viewZones.erase(std::remove_if(s_viewZones.begin(), s_viewZones.end(), outside), s_viewZones.end());
+
+		// Zones are written when they close, children first: parents are put back in front
+		std::sort(s_viewZones.begin(), s_viewZones.end(), [](const Zone& lhs, const Zone& rhs)
+		{
+			return lhs.start != rhs.start ? lhs.start < rhs.start : lhs.depth < rhs.depth;
+		});
+
+		for (const Zone& zone : s_viewZones)
+		{
+			if (zone.allocations > 0)
+				ImGui::Text("%*s%s %.3f ms, %u allocations", (int)zone.depth * 2, "", zone.name, (double)(zone.end - zone.start) * 1e-6, zone.allocations);
+			else
+				ImGui::Text("%*s%s %.3f ms", (int)zone.depth * 2, "", zone.name, (double)(zone.end - zone.start) * 1e-6);
+		}
+
+		ImGui::TreePop();
+	}
+
+	ImGui::End();
+}
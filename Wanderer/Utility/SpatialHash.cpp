@@ -0,0 +1,197 @@
+#include "Utility/SpatialHash.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(float cellSize)
+	: m_cellSize(cellSize)
+{
+}
+
+int SpatialHash::toCell(float coordinate) const
+{
+	return (int)std::floor(coordinate / m_cellSize);
+}
+
+SpatialHash::CellRange SpatialHash::getCells(const Box& box) const
+{
+	// the far edges are included: boxContains() is inclusive
+	return { toCell(box.x), toCell(box.y), toCell(box.x + box.w), toCell(box.y + box.h) };
+}
+
+void SpatialHash::link(std::uint32_t id, const CellRange& cells)
+{
+	for (int y = cells.minY; y <= cells.maxY; ++y)
+	{
+		for (int x = cells.minX; x <= cells.maxX; ++x)
+		{
+			auto it = m_cells.find(makeCellKey(x, y));
+			if (it == m_cells.end())
+			{
+				std::vector<std::uint32_t> cell;
+				if (!m_freeCells.empty())
+				{
+					cell = std::move(m_freeCells.back());
+					m_freeCells.pop_back();
+				}
+				else
+					cell.reserve(CELL_CAPACITY);	// one allocation per new cell rather than one per doubling
+				it = m_cells.emplace(makeCellKey(x, y), std::move(cell)).first;
+			}
+			it->second.push_back(id);
+		}
+	}
+}
+
+void SpatialHash::unlink(std::uint32_t id, const CellRange& cells)
+{
+	for (int y = cells.minY; y <= cells.maxY; ++y)
+	{
+		for (int x = cells.minX; x <= cells.maxX; ++x)
+		{
+			auto cellIt = m_cells.find(makeCellKey(x, y));
+			if (cellIt == m_cells.end())
+				continue;
+
+			std::vector<std::uint32_t>& cell = cellIt->second;
+			auto it = std::find(cell.begin(), cell.end(), id);
+			if (it != cell.end())
+			{
+				*it = cell.back();
+				cell.pop_back();
+			}
+
+			// Only occupied cells stay in the map: findOverlappingPairs() walks all of them
+			if (cell.empty())
+			{
+				releaseCell(std::move(cell));
+				m_cells.erase(cellIt);
+			}
+		}
+	}
+}
+
+void SpatialHash::releaseCell(std::vector<std::uint32_t>&& cell)
+{
+	cell.clear();
+	m_freeCells.push_back(std::move(cell));
+}
+
+void SpatialHash::insert(std::uint32_t id, const Box& box)
+{
+	if (id >= m_items.size())
+		m_items.resize(id + 1);
+
+	Item& item = m_items[id];
+	if (item.present)
+	{
+		update(id, box);
+		return;
+	}
+
+	item.box = box;
+	item.cells = getCells(box);
+	item.present = true;
+	link(id, item.cells);
+}
+
+void SpatialHash::update(std::uint32_t id, const Box& box)
+{
+	if (id >= m_items.size() || !m_items[id].present)
+	{
+		insert(id, box);
+		return;
+	}
+
+	Item& item = m_items[id];
+	item.box = box;
+
+	const CellRange cells = getCells(box);
+	if (cells == item.cells)	// moved within the same cells: most frames
+		return;
+
+	unlink(id, item.cells);
+	link(id, cells);
+	item.cells = cells;
+}
+
+void SpatialHash::remove(std::uint32_t id)
+{
+	if (id >= m_items.size() || !m_items[id].present)
+		return;
+
+	unlink(id, m_items[id].cells);
+	m_items[id].present = false;
+}
+
+void SpatialHash::clear()
+{
+	for (auto& cell : m_cells)
+		releaseCell(std::move(cell.second));
+	m_cells.clear();
+	for (Item& item : m_items)
+		item.present = false;
+}
+
+void SpatialHash::query(const Box& region, std::vector<std::uint32_t>& ids) const
+{
+	++m_stamp;
+	const CellRange cells = getCells(region);
+	for (int y = cells.minY; y <= cells.maxY; ++y)
+	{
+		for (int x = cells.minX; x <= cells.maxX; ++x)
+		{
+			auto it = m_cells.find(makeCellKey(x, y));
+			if (it == m_cells.end())
+				continue;
+
+			for (std::uint32_t id : it->second)
+			{
+				const Item& item = m_items[id];
+				if (item.stamp != m_stamp && boxesOverlapping(item.box, region))
+				{
+					item.stamp = m_stamp;
+					ids.push_back(id);
+				}
+			}
+		}
+	}
+}
+
+void SpatialHash::pick(const sf::Vector2f& point, std::vector<std::uint32_t>& ids) const
+{
+	// a single cell: every box containing the point references it
+	auto it = m_cells.find(makeCellKey(toCell(point.x), toCell(point.y)));
+	if (it == m_cells.end())
+		return;
+
+	for (std::uint32_t id : it->second)
+	{
+		if (boxContains(m_items[id].box, point))
+			ids.push_back(id);
+	}
+}
+
+void SpatialHash::findOverlappingPairs(std::vector<std::pair<std::uint32_t, std::uint32_t>>& pairs) const
+{
+	for (const auto& [key, cell] : m_cells)
+	{
+		const int cellX = (int)(std::int32_t)(std::uint32_t)(key >> 32);
+		const int cellY = (int)(std::int32_t)(std::uint32_t)key;
+
+		for (std::size_t i = 0; i < cell.size(); ++i)
+		{
+			const Box& a = m_items[cell[i]].box;
+			for (std::size_t j = i + 1; j < cell.size(); ++j)
+			{
+				const Box& b = m_items[cell[j]].box;
+				if (!boxesOverlapping(a, b))
+					continue;
+
+				// A pair shares several cells when it straddles them: reported by the cell holding the intersection's corner
+				if (toCell(std::max(a.x, b.x)) == cellX && toCell(std::max(a.y, b.y)) == cellY)
+					pairs.emplace_back(std::min(cell[i], cell[j]), std::max(cell[i], cell[j]));
+			}
+		}
+	}
+}
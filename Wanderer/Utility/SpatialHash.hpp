@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Utility/Box.hpp"
+
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** Uniform grid over boxes, for entity-versus-entity queries. Ids are small integers (e.g. World slots),
+ *  a box is referenced by every cell it touches. Queries only test the boxes of the cells they cover **/
+class SpatialHash
+{
+public:
+	explicit SpatialHash(float cellSize);
+
+	// Incremental: update() only touches the cells the box entered or left
+	void insert(std::uint32_t id, const Box& box);
+	void update(std::uint32_t id, const Box& box);
+	void remove(std::uint32_t id);
+	void clear();
+
+	// Results are appended, each id once
+	void query(const Box& region, std::vector<std::uint32_t>& ids) const;	// boxes overlapping region
+	void pick(const sf::Vector2f& point, std::vector<std::uint32_t>& ids) const;	// boxes containing point
+	void findOverlappingPairs(std::vector<std::pair<std::uint32_t, std::uint32_t>>& pairs) const;
+
+	[[nodiscard]] float getCellSize() const { return m_cellSize; }
+
+private:
+	struct CellRange
+	{
+		int minX, minY, maxX, maxY;	// inclusive
+		bool operator==(const CellRange& o) const { return minX == o.minX && minY == o.minY && maxX == o.maxX && maxY == o.maxY; }
+	};
+
+	struct Item
+	{
+		Box box;
+		CellRange cells;
+		bool present = false;
+		mutable std::uint32_t stamp = 0;	// last query that reported it, to report it once
+	};
+
+	[[nodiscard]] int toCell(float coordinate) const;
+	[[nodiscard]] CellRange getCells(const Box& box) const;
+	void link(std::uint32_t id, const CellRange& cells);
+	void unlink(std::uint32_t id, const CellRange& cells);
+	void releaseCell(std::vector<std::uint32_t>&& cell);
+
+	static std::uint64_t makeCellKey(int x, int y) { return ((std::uint64_t)(std::uint32_t)x << 32) | (std::uint32_t)y; }
+
+	static constexpr std::size_t CELL_CAPACITY = 8;	// ids a cell holds before growing
+
+	float m_cellSize;
+	std::vector<Item> m_items;	// indexed by id
+	std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_cells;	// occupied cells only
+	std::vector<std::vector<std::uint32_t>> m_freeCells;	// emptied cells, their storage is reused by the next new cells
+	mutable std::uint32_t m_stamp = 0;
+};
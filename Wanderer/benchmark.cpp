@@ -0,0 +1,238 @@
+#include "Scene/Simulation.hpp"
+#include "Constants.hpp"
+#include "Utility/AllocationTracker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/** Times the engine hot paths on real and generated levels, without window:
+ *
+ *    WandererBenchmark [--csv results.csv] [--max-size 10000] [--entities 2000] [--min-time 0.2]
+ *
+ *  One CSV row per (level, benchmark): a run is compared to another by joining on these two columns **/
+class Benchmark
+{
+public:
+	Benchmark(const std::string& csvFilename, double minTime)
+		: m_csv(csvFilename), m_minTime(minTime)
+	{
+		m_csv << "level,width,height,chunks,entities,benchmark,iterations,ops,total_ms,ns_per_op,allocations_per_op\n";
+	}
+
+	[[nodiscard]] bool isOpen() const { return (bool)m_csv; }
+
+	// Level shipped with the game: its own map and entities
+	void runLevel(const std::string& name)
+	{
+		Simulation simulation;
+		const std::string levelFilename = LEVELS_PATH + name;
+		if (!simulation.loadLevel(levelFilename, true))
+		{
+			std::cerr << "Benchmark: can't load " << levelFilename << std::endl;
+			return;
+		}
+		runAll(simulation, name, levelFilename + "/map.txt");
+	}
+
+	// size * size tiles: ground every GROUND_SPACING rows with gaps and short ladders, enemies spread on the grounds
+	void runGenerated(int size, int enemies)
+	{
+		const std::string mapFilename = "benchmark_map.txt";
+		if (!generateMap(mapFilename, size))
+			return;
+
+		Simulation simulation;
+		simulation.getTilesManager().loadTiles(TEXTURES_PATH + "tilesData.json");
+		if (!simulation.getMap().load(mapFilename))
+		{
+			std::remove(mapFilename.c_str());
+			return;
+		}
+
+		std::mt19937 rng(42);
+		const int grounds = std::max(size / GROUND_SPACING, 1);
+		auto spawnOnGround = [&](LevelEntity::Type type)
+		{
+			const int x = 1 + (int)(rng() % (unsigned)std::max(size - 2, 1));
+			const int ground = (int)(rng() % (unsigned)grounds);
+			const int y = ground * GROUND_SPACING + GROUND_SPACING - 3;	// falls on the ground row
+			simulation.spawnEntity(type, (float)x * TILE_SIZEf, (float)y * TILE_SIZEf);
+		};
+		spawnOnGround(LevelEntity::Type::Player);
+		for (int i = 0; i < enemies; ++i)
+			spawnOnGround(LevelEntity::Type::Enemy);
+
+		runAll(simulation, "generated_" + std::to_string(size), mapFilename);
+		std::remove(mapFilename.c_str());
+	}
+
+private:
+	static constexpr int GROUND_SPACING = 64;	// rows: keeps 10000x10000 maps sparse enough to fit in memory
+
+	static bool generateMap(const std::string& filename, int size)
+	{
+		std::ofstream file(filename, std::ios::binary);
+		if (!file)
+		{
+			std::cerr << "Benchmark: can't create " << filename << std::endl;
+			return false;
+		}
+
+		std::string row;
+		row.reserve((std::size_t)size * 2 + 1);
+		for (int y = 0; y < size; ++y)
+		{
+			row.clear();
+			const bool groundRow = y % GROUND_SPACING == GROUND_SPACING - 1 || y == size - 1;
+			for (int x = 0; x < size; ++x)
+			{
+				char tile = '.';
+				if (groundRow && x % 50 != 25)	// a gap every 50 tiles
+					tile = (x / 50) % 2 ? 'a' : 'b';
+				else if (x % 40 == 20 && y % GROUND_SPACING >= GROUND_SPACING - 8)	// ladders, in the chunk row of their ground
+					tile = 'l';
+				row += tile;
+				row += ' ';
+			}
+			row += '\n';
+			file.write(row.data(), (std::streamsize)row.size());
+		}
+		return (bool)file;
+	}
+
+	void runAll(Simulation& simulation, const std::string& level, const std::string& mapFilename)
+	{
+		Map& map = simulation.getMap();
+		World& world = simulation.getWorld();
+		const float dt = SIMULATION_STEP;
+
+		// The map was just loaded once: the file is in the OS cache for every run
+		measure(simulation, level, "map_load", 1, [&] { map.load(mapFilename); });
+		measure(simulation, level, "regenerate_vertices", 1, [&] { map.regenerateVertices(); });
+
+		// A tile added just outside then removed: bounds grow, then are recomputed
+		const TilesManager& tiles = simulation.getTilesManager();
+		const TileId solid = tiles.getTileFromIndex('a');
+		const TileId empty = tiles.getDefaultTile();
+		measure(simulation, level, "set_tile_edge", 1, [&]
+		{
+			const sf::IntRect bounds = map.getBounds();
+			const int x = bounds.left + bounds.width;
+			const int y = bounds.top + bounds.height - 1;
+			map.setTile(x, y, solid);
+			map.setTile(x, y, empty);
+			(void)map.getBounds();
+		});
+
+		// Random entity sized boxes over the whole map
+		const sf::IntRect bounds = map.getBounds();
+		std::mt19937 rng(7);
+		std::vector<Box> boxes(4096);
+		for (Box& box : boxes)
+		{
+			box.x = ((float)bounds.left + (float)(rng() % (unsigned)std::max(bounds.width, 1))) * TILE_SIZEf;
+			box.y = ((float)bounds.top + (float)(rng() % (unsigned)std::max(bounds.height, 1))) * TILE_SIZEf;
+			box.w = TILE_SIZEf;
+			box.h = 2.f * TILE_SIZEf;
+		}
+		std::size_t touching = 0;
+		measure(simulation, level, "touching_tile", boxes.size(), [&]
+		{
+			for (const Box& box : boxes)
+				touching += map.touchingTile(box, Tile::Property::Solid) ? 1 : 0;
+		});
+
+		// One op = one entity moved against the map during one step
+		measure(simulation, level, "move_entity", world.size(), [&]
+		{
+			world.updateKinematics(dt);
+			for (std::size_t i = 0; i < world.size(); ++i)
+			{
+				if (world.kinds[i] == EntityKind::Enemy)
+					simulation.moveEnemy(i);
+				else
+					simulation.moveEntity(i);
+			}
+		});
+
+		measure(simulation, level, "update_animations", world.size(), [&] { world.updateAnimations(dt); });
+		measure(simulation, level, "simulation_step", 1, [&] { simulation.step(PlayerInput(), dt); });
+
+		if (touching == (std::size_t)-1)	// keeps the queries from being optimized out
+			std::cerr << touching << std::endl;
+	}
+
+	// Runs f until minTime elapsed (at least once), ops: work units done by one call of f
+	void measure(const Simulation& simulation, const std::string& level, const char* name, std::size_t ops, const std::function<void()>& f)
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		std::size_t iterations = 0;
+		const std::uint64_t allocationsBefore = AllocationTracker::getThreadAllocations();
+		const Clock::time_point start = Clock::now();
+		std::chrono::duration<double> elapsed{};
+		do
+		{
+			f();
+			++iterations;
+			elapsed = Clock::now() - start;
+		} while (elapsed.count() < m_minTime);
+		const std::uint64_t allocations = AllocationTracker::getThreadAllocations() - allocationsBefore;
+
+		const sf::IntRect bounds = simulation.getMap().getBounds();
+		const double totalOps = (double)iterations * (double)std::max(ops, (std::size_t)1);
+		m_csv << level << ',' << bounds.width << ',' << bounds.height << ',' << simulation.getMap().getChunkCount()
+			  << ',' << simulation.getWorld().size() << ',' << name << ',' << iterations << ',' << (std::size_t)totalOps
+			  << ',' << elapsed.count() * 1e3 << ',' << elapsed.count() * 1e9 / totalOps << ',' << (double)allocations / totalOps << '\n' << std::flush;
+		std::cerr << level << ' ' << name << ": " << elapsed.count() * 1e9 / totalOps << " ns/op" << std::endl;
+	}
+
+	std::ofstream m_csv;
+	double m_minTime;
+};
+
+int main(int argc, char** argv)
+{
+	std::string csvFilename = "benchmark.csv";
+	int maxSize = 10000;
+	int enemies = 2000;
+	double minTime = 0.2;
+	for (int i = 1; i < argc; i += 2)
+	{
+		std::string option = argv[i];
+		if (i + 1 == argc)
+			option.clear();	// no value: usage
+
+		if (option == "--csv")				csvFilename = argv[i + 1];
+		else if (option == "--max-size")	maxSize = std::atoi(argv[i + 1]);
+		else if (option == "--entities")	enemies = std::atoi(argv[i + 1]);
+		else if (option == "--min-time")	minTime = std::atof(argv[i + 1]);
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--csv results.csv] [--max-size 10000] [--entities 2000] [--min-time 0.2]" << std::endl;
+			return 1;
+		}
+	}
+
+	Benchmark benchmark(csvFilename, minTime);
+	if (!benchmark.isOpen())
+	{
+		std::cerr << "Benchmark: can't create " << csvFilename << std::endl;
+		return 1;
+	}
+
+	benchmark.runLevel("parkour");
+	benchmark.runLevel("eloi");
+	for (int size = 100; size <= maxSize; size *= 10)
+		benchmark.runGenerated(size, enemies);
+
+	return 0;
+}
@@ -0,0 +1,138 @@
+#include "Scene/Simulation.hpp"
+#include "Scene/InputScript.hpp"
+#include "Scene/Replay.hpp"
+#include "Constants.hpp"
+#include "Utility/AllocationTracker.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	void printPlayer(const Simulation& simulation)
+	{
+		const World& world = simulation.getWorld();
+		const std::size_t player = simulation.getPlayer();
+		std::cout << " entities=" << world.size()
+				  << " player_x=" << world.positions[player].x
+				  << " player_y=" << world.positions[player].y
+				  << " player_hp=" << world.healths[player].hp;
+	}
+
+	void printTiming(std::uint64_t steps, const std::chrono::duration<double>& elapsed, std::uint64_t allocations)
+	{
+		std::cout << "steps=" << steps
+				  << " seconds=" << elapsed.count()
+				  << " steps_per_second=" << (elapsed.count() > 0.0 ? (double)steps / elapsed.count() : 0.0)
+				  << " allocations_per_step=" << (steps > 0 ? (double)allocations / (double)steps : 0.0);
+	}
+
+	int playReplay(const std::string& filename)
+	{
+		Replay replay;
+		if (!replay.load(filename))
+			return 1;
+
+		Simulation simulation;
+		ReplayPlayer player(simulation, replay);
+		if (!simulation.loadLevel(replay.getLevel()) || !player.start())
+			return 1;
+
+		const std::uint64_t allocations = AllocationTracker::getThreadAllocations();
+		const auto start = std::chrono::steady_clock::now();
+		while (!player.isFinished())
+			player.step();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		printTiming(replay.getTickCount(), elapsed, AllocationTracker::getThreadAllocations() - allocations);
+		printPlayer(simulation);
+		const bool inSync = player.getDivergentTick() == ReplayPlayer::NO_DIVERGENCE;
+		std::cout << " final_state=" << (player.isFinalStateMatching() ? "match" : "mismatch") << " divergent_tick=";
+		if (inSync)
+			std::cout << "none" << std::endl;
+		else
+			std::cout << player.getDivergentTick() << std::endl;
+		return inSync && player.isFinalStateMatching() ? 0 : 2;
+	}
+}
+
+/** Runs a level without window nor graphics context, as fast as the CPU allows:
+ *
+ *    WandererHeadless <level directory> [input script] [steps] [--record replay.wrpl]
+ *    WandererHeadless --replay <replay.wrpl>
+ *
+ *  Steps default to the script length + one second. Prints one key=value line per run.
+ *  A replay is checked tick by tick against its recording, then its final player state: the exit code is 2 if either differs **/
+int main(int argc, char** argv)
+{
+	// Positional arguments, then options
+	std::vector<std::string> arguments;
+	std::string replayFilename;
+	std::string recordFilename;
+	bool usage = argc < 2;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string argument = argv[i];
+		if ((argument == "--replay" || argument == "--record") && i + 1 < argc)
+			(argument == "--replay" ? replayFilename : recordFilename) = argv[++i];
+		else if (argument.rfind("--", 0) == 0)
+			usage = true;
+		else
+			arguments.push_back(argument);
+	}
+	if (usage || (replayFilename.empty() == arguments.empty()) || arguments.size() > 3)
+	{
+		std::cerr << "usage: " << argv[0] << " <level directory> [input script] [steps] [--record replay.wrpl]\n"
+				  << "       " << argv[0] << " --replay <replay.wrpl>" << std::endl;
+		return 1;
+	}
+
+	if (!replayFilename.empty())
+		return playReplay(replayFilename);
+
+	Simulation simulation;
+	if (!simulation.loadLevel(arguments[0]))
+		return 1;
+
+	InputScript script;
+	if (arguments.size() >= 2 && !script.load(arguments[1]))
+		return 1;
+
+	const std::uint64_t steps = arguments.size() >= 3 ? std::strtoull(arguments[2].c_str(), nullptr, 10)
+													  : script.getLastTick() + (std::uint64_t)SIMULATION_RATE;
+	const float dt = SIMULATION_STEP;
+
+	// Recorded runs are fully resident, as their playback (see ReplayPlayer::start())
+	Replay replay;
+	if (!recordFilename.empty())
+	{
+		simulation.getMap().stopStreaming();
+		replay.clear(arguments[0]);
+	}
+
+	const std::uint64_t allocations = AllocationTracker::getThreadAllocations();
+	const auto start = std::chrono::steady_clock::now();
+	for (std::uint64_t tick = 0; tick < steps; ++tick)
+	{
+		const PlayerInput input = script.at(tick);
+		simulation.step(input, dt);
+		if (!recordFilename.empty())
+			replay.record(input, simulation);
+
+		// No camera: the level streams around the player
+		const World& world = simulation.getWorld();
+		simulation.updateStreaming(world.positions[simulation.getPlayer()]);
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	printTiming(steps, elapsed, AllocationTracker::getThreadAllocations() - allocations);
+	printPlayer(simulation);
+	std::cout << std::endl;
+
+	if (!recordFilename.empty() && !replay.save(recordFilename))
+		return 1;
+	return 0;
+}
@@ -1,8 +1,14 @@
 #include "Game.hpp"
+#include "Utility/Logger.hpp"
 
 int main()
 {
-	Game game;
+	Logger::start("wanderer.log");	// before the scenes are created, they log while loading
 
+	{
+		Game game;
+	}
+
+	Logger::stop();
 	return 0;
 }
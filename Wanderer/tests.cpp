@@ -0,0 +1,525 @@
+#include "Scene/Simulation.hpp"
+#include "Scene/InputScript.hpp"
+#include "Scene/LevelFile.hpp"
+#include "Constants.hpp"
+#include "Utility/SpatialHash.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** Map internals for the checks below **/
+struct MapTests
+{
+	static const TileChunk* findChunk(const Map& map, int x, int y)
+	{
+		auto it = map.m_chunks.find(makeChunkKey(tileToChunk(x), tileToChunk(y)));
+		return it != map.m_chunks.end() ? &it->second : nullptr;
+	}
+
+	// Every drawn cell owns one quad at its position, and the quad knows its cell
+	static bool areQuadsConsistent(const Map& map, const TileChunk& chunk, const sf::Vector2i& origin)
+	{
+		if (chunk.vertices.size() != chunk.quadCells.size() * 4)
+			return false;
+
+		std::size_t drawn = 0;
+		for (int cell = 0; cell < CHUNK_SIZEi * CHUNK_SIZEi; ++cell)
+		{
+			const int quad = chunk.quads[cell];
+			if ((quad != TileChunk::NO_QUAD) != (map.m_tilesMgr.getTilePropertyFromId(chunk.tiles[cell]) != Tile::Property::Void))
+				return false;
+			if (quad == TileChunk::NO_QUAD)
+				continue;
+
+			++drawn;
+			const sf::Vector2f position((float)((origin.x + cell % CHUNK_SIZEi) * TILE_SIZEi), (float)((origin.y + cell / CHUNK_SIZEi) * TILE_SIZEi));
+			if (chunk.quadCells[quad] != cell || chunk.vertices[(std::size_t)quad * 4].position != position)
+				return false;
+		}
+		return drawn == chunk.quadCells.size();
+	}
+};
+
+namespace
+{
+	int failures = 0;
+
+	void check(bool condition, const char* expression, int line)
+	{
+		if (condition)
+			return;
+		std::cerr << "tests.cpp:" << line << ": check failed: " << expression << std::endl;
+		++failures;
+	}
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+	// The shipped tiles registry: '.' void (default), 'a' solid, 'l' ladder
+	TilesManager& getTiles()
+	{
+		static TilesManager tiles;
+		if (tiles.getTiles().empty())
+			tiles.loadTiles(TEXTURES_PATH + "tilesData.json");
+		return tiles;
+	}
+
+	// Tiles on both sides of chunk edges, negative coordinates included: tile -1 is in chunk -1
+	void testMapChunkBoundaries()
+	{
+		const TilesManager& tiles = getTiles();
+		const TileId solid = tiles.getTileFromIndex('a');
+		const TileId empty = tiles.getDefaultTile();
+		Map map(getTiles());
+
+		const std::vector<sf::Vector2i> cells = {
+			{ 0, 0 }, { -1, 0 }, { CHUNK_SIZEi - 1, 0 }, { CHUNK_SIZEi, 0 },
+			{ 0, -1 }, { -1, -1 }, { -CHUNK_SIZEi, -CHUNK_SIZEi - 1 }
+		};
+		for (const sf::Vector2i& cell : cells)
+			map.setTile(cell.x, cell.y, solid);
+
+		for (const sf::Vector2i& cell : cells)
+			CHECK(map.getTile(cell.x, cell.y) == solid);
+		CHECK(map.getTile(1, 0) == empty && map.getTile(-2, -1) == empty && map.getTile(CHUNK_SIZEi, 1) == empty);
+
+		// chunks (0, 0), (-1, 0), (1, 0), (0, -1), (-1, -1), (-1, -2)
+		CHECK(map.getChunkCount() == 6);
+		CHECK(map.getBounds() == sf::IntRect(-CHUNK_SIZEi, -CHUNK_SIZEi - 1, 2 * CHUNK_SIZEi + 1, CHUNK_SIZEi + 2));
+
+		// Erasing the last tile of a chunk drops it, the bounds shrink
+		map.setTile(-CHUNK_SIZEi, -CHUNK_SIZEi - 1, empty);
+		CHECK(map.getChunkCount() == 5);
+		CHECK(map.getBounds() == sf::IntRect(-1, -1, CHUNK_SIZEi + 2, 2));
+	}
+
+	// setTile() patches, appends or swap-removes one quad: the moved quad's cell must follow
+	void testMapQuadUpdates()
+	{
+		const TilesManager& tiles = getTiles();
+		const TileId solid = tiles.getTileFromIndex('a');
+		const TileId ladder = tiles.getTileFromIndex('l');
+		const TileId empty = tiles.getDefaultTile();
+		Map map(getTiles());
+
+		// negative chunk: its origin is (-CHUNK_SIZEi, -CHUNK_SIZEi)
+		const sf::Vector2i origin(-CHUNK_SIZEi, -CHUNK_SIZEi);
+		for (int x = 0; x < 4; ++x)
+			map.setTile(origin.x + x, origin.y + 3, solid);
+
+		const TileChunk* chunk = MapTests::findChunk(map, origin.x, origin.y);
+		CHECK(chunk && chunk->quadCells.size() == 4 && MapTests::areQuadsConsistent(map, *chunk, origin));
+
+		map.setTile(origin.x, origin.y + 3, empty);			// first quad: the last one moves in its slot
+		CHECK(chunk->quadCells.size() == 3 && MapTests::areQuadsConsistent(map, *chunk, origin));
+		CHECK(chunk->quads[3 * CHUNK_SIZEi + 3] == 0);
+
+		map.setTile(origin.x + 2, origin.y + 3, empty);		// now the last quad: nothing moves
+		CHECK(chunk->quadCells.size() == 2 && MapTests::areQuadsConsistent(map, *chunk, origin));
+
+		map.setTile(origin.x + 1, origin.y + 3, ladder);	// patched in place
+		CHECK(chunk->quadCells.size() == 2 && MapTests::areQuadsConsistent(map, *chunk, origin));
+		CHECK(chunk->vertices[(std::size_t)chunk->quads[3 * CHUNK_SIZEi + 1] * 4].texCoords == tiles.getTileTexCoordsFromId(ladder));
+	}
+
+	// A fresh Map has no virtual ground yet, so every query would hit it: load one empty tile to set it up
+	bool loadEmptyMap(Map& map, const std::string& directory)
+	{
+		const std::string filename = directory + "/empty_map.txt";
+		std::ofstream(filename) << ".\n";
+		return map.load(filename);
+	}
+
+	// Box queries read the bitplanes of every chunk overlapped, missing chunks are void
+	void testMapTouchedProperties(const std::string& directory)
+	{
+		const TilesManager& tiles = getTiles();
+		Map map(getTiles());
+		CHECK(loadEmptyMap(map, directory));
+
+		// solid | ladder on both sides of a chunk edge, above the origin
+		map.setTile(CHUNK_SIZEi - 1, -1, tiles.getTileFromIndex('a'));
+		map.setTile(CHUNK_SIZEi, -1, tiles.getTileFromIndex('l'));
+
+		const Tile::PropertyMask solid = Tile::bit(Tile::Property::Solid);
+		const Tile::PropertyMask ladder = Tile::bit(Tile::Property::Ladder);
+		const Tile::PropertyMask empty = Tile::bit(Tile::Property::Void);
+		const float edge = (float)CHUNK_SIZEi * TILE_SIZEf;
+
+		CHECK(map.touchedProperties(Box{ edge - TILE_SIZEf, -TILE_SIZEf, TILE_SIZEf, TILE_SIZEf }) == solid);
+		CHECK(map.touchedProperties(Box{ edge - 10.f, -TILE_SIZEf, 20.f, TILE_SIZEf }) == (solid | ladder));
+		CHECK(map.touchedProperties(Box{ edge - 10.f, -TILE_SIZEf - 10.f, 20.f, TILE_SIZEf }) == (solid | ladder | empty));
+
+		// Overlapping a tile by less than SWEEP_EPSILON is only touching it
+		const float flush = Map::SWEEP_EPSILON / 2.f;
+		CHECK(map.touchedProperties(Box{ edge - flush, -TILE_SIZEf + flush, TILE_SIZEf, TILE_SIZEf }) == ladder);
+
+		// Nothing stored there
+		CHECK(map.touchedProperties(Box{ -10.f * edge, -10.f * edge, TILE_SIZEf, TILE_SIZEf }) == empty);
+	}
+
+	// Sweeps stop flush against the first solid row/column on the way, however far the box goes in one step
+	void testMapSweeps(const std::string& directory)
+	{
+		const TileId solid = getTiles().getTileFromIndex('a');
+		Map map(getTiles());
+		CHECK(loadEmptyMap(map, directory));
+
+		// one tile thick: a floor on row 10 (y in [500, 550)), a wall on column 10 (x in [500, 550))
+		for (int i = 0; i < 4; ++i)
+		{
+			map.setTile(i, 10, solid);
+			map.setTile(10, i, solid);
+		}
+
+		// Falling far more than a tile in one step: no tunneling
+		Map::Sweep sweep = map.sweepY(Box{ 50.f, 100.f, 40.f, 60.f }, 1000.f, Tile::Property::Solid);
+		CHECK(sweep.time == 340.f / 1000.f && sweep.normal == sf::Vector2i(0, -1));
+
+		sweep = map.sweepY(Box{ 50.f, 600.f, 40.f, 60.f }, -1000.f, Tile::Property::Solid);
+		CHECK(sweep.time == -50.f / -1000.f && sweep.normal == sf::Vector2i(0, 1));
+
+		sweep = map.sweepX(Box{ 0.f, 50.f, 40.f, 50.f }, 2000.f, Tile::Property::Solid);
+		CHECK(sweep.time == 460.f / 2000.f && sweep.normal == sf::Vector2i(-1, 0));
+
+		// Resting on the floor with a rounding error: still in contact, not inside it
+		const float flush = Map::SWEEP_EPSILON / 2.f;
+		sweep = map.sweepY(Box{ 50.f, 440.f + flush, 40.f, 60.f }, 5.f, Tile::Property::Solid);
+		CHECK(sweep.time == 0.f && sweep.normal == sf::Vector2i(0, -1));
+
+		sweep = map.sweepX(Box{ 460.f + flush, 50.f, 40.f, 50.f }, 5.f, Tile::Property::Solid);
+		CHECK(sweep.time == 0.f && sweep.normal == sf::Vector2i(-1, 0));
+
+		// ...and free to leave it
+		sweep = map.sweepY(Box{ 50.f, 440.f + flush, 40.f, 60.f }, -5.f, Tile::Property::Solid);
+		CHECK(sweep.time == 1.f && sweep.normal == sf::Vector2i(0, 0));
+
+		// Moving along the floor, flush against it: not blocked by it
+		sweep = map.sweepX(Box{ 0.f, 440.f + flush, 40.f, 60.f }, 100.f, Tile::Property::Solid);
+		CHECK(sweep.time == 1.f && sweep.normal == sf::Vector2i(0, 0));
+	}
+
+	// Boxes straddling several cells share them: each overlapping pair must still be reported once
+	void testSpatialHashPairs()
+	{
+		SpatialHash hash(100.f);
+		const std::vector<Box> boxes = {
+			{ 90.f, 90.f, 20.f, 20.f },		// on the corner of 4 cells
+			{ 95.f, 95.f, 30.f, 30.f },		// overlaps 0 in the 4 cells
+			{ 50.f, 50.f, 200.f, 10.f },	// overlaps 0 and 1, spans 3 columns
+			{ 400.f, 400.f, 10.f, 10.f },	// alone
+			{ -20.f, -20.f, 40.f, 40.f }	// negative cells
+		};
+		for (std::uint32_t id = 0; id < boxes.size(); ++id)
+			hash.insert(id, boxes[id]);
+
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+		hash.findOverlappingPairs(pairs);
+		std::sort(pairs.begin(), pairs.end());
+
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> expected;
+		for (std::uint32_t a = 0; a < boxes.size(); ++a)
+		{
+			for (std::uint32_t b = a + 1; b < boxes.size(); ++b)
+			{
+				if (boxesOverlapping(boxes[a], boxes[b]))
+					expected.emplace_back(a, b);
+			}
+		}
+		CHECK(pairs == expected);
+
+		// Moved away then removed: nothing left to report
+		hash.update(1, { 1000.f, 1000.f, 10.f, 10.f });
+		hash.remove(2);
+		pairs.clear();
+		hash.findOverlappingPairs(pairs);
+		CHECK(pairs.empty());
+
+		hash.clear();
+		std::vector<std::uint32_t> ids;
+		hash.query({ -1000.f, -1000.f, 3000.f, 3000.f }, ids);
+		CHECK(ids.empty());
+	}
+
+	// A despawned entity's handle stays stale, even once its slot is reused by another entity
+	void testWorldHandles()
+	{
+		World world;
+		const EntityHandle a = world.spawn(EntityKind::Enemy, { 0.f, 0.f }, nullptr, 100.f);
+		const EntityHandle b = world.spawn(EntityKind::Enemy, { 100.f, 0.f }, nullptr, 100.f);
+		const EntityHandle c = world.spawn(EntityKind::Enemy, { 200.f, 0.f }, nullptr, 100.f);
+
+		CHECK(world.despawn(a));
+		CHECK(!world.isValid(a) && !world.despawn(a));
+		CHECK(world.isValid(b) && world.isValid(c) && world.size() == 2);
+		CHECK(world.indexOf(c) == 0 && world.positions[0] == sf::Vector2f(200.f, 0.f));	// the last one filled the hole
+
+		const EntityHandle d = world.spawn(EntityKind::Enemy, { 300.f, 0.f }, nullptr, 100.f);
+		CHECK(d.slot == a.slot && d.generation != a.generation);
+		CHECK(!world.isValid(a) && world.isValid(d));
+		CHECK(world.handleOf(world.indexOf(d)) == d && world.positions[world.indexOf(d)] == sf::Vector2f(300.f, 0.f));
+
+		world.clear();
+		CHECK(!world.isValid(b) && !world.isValid(c) && !world.isValid(d));
+	}
+
+	// Runs longer than 255 cells are split, chunks and entities come back as written
+	void testLevelFileRoundTrip(const std::string& directory)
+	{
+		const int chunkSize = 16;
+		LevelChunk uniform{ { -1, 2 }, std::vector<std::uint8_t>(chunkSize * chunkSize, 1) };
+		LevelChunk mixed{ { 0, 0 }, std::vector<std::uint8_t>(chunkSize * chunkSize) };
+		for (std::size_t i = 0; i < mixed.cells.size(); ++i)
+			mixed.cells[i] = (std::uint8_t)(i % 7 < 3 ? 0 : i % 3);
+
+		const std::vector<LevelEntity> entities = {
+			{ LevelEntity::Type::Player, 12.5f, -3.f },
+			{ LevelEntity::Type::Enemy, 400.f, 250.25f }
+		};
+		const std::string filename = directory + "/roundtrip.bin";
+		CHECK(LevelFile::write(filename, chunkSize, ".ab", { uniform, mixed }, entities));
+
+		LevelFile file;
+		CHECK(file.open(filename));
+		CHECK(file.getChunkSize() == chunkSize);
+		CHECK(file.getPalette() == ".ab");
+		CHECK(file.getChunkCount() == 2);
+
+		std::vector<std::uint8_t> cells;
+		for (std::size_t c = 0; c < file.getChunkCount(); ++c)
+		{
+			const LevelChunk& written = file.getChunkCoords(c) == uniform.coords ? uniform : mixed;
+			CHECK(file.decodeChunk(c, cells));
+			CHECK(cells == written.cells);
+		}
+
+		CHECK(file.getEntities().size() == entities.size());
+		for (std::size_t i = 0; i < std::min(entities.size(), file.getEntities().size()); ++i)
+		{
+			const LevelEntity& read = file.getEntities()[i];
+			CHECK(read.type == entities[i].type && read.x == entities[i].x && read.y == entities[i].y);
+		}
+		file.close();
+
+		// A level has one player, a chunk is stored once
+		CHECK(LevelFile::write(filename, chunkSize, ".ab", { uniform, mixed }, { entities[0], entities[1], entities[0] }));
+		CHECK(!file.open(filename) && !file.isOpen());
+		CHECK(LevelFile::write(filename, chunkSize, ".ab", { uniform, mixed, uniform }, entities));
+		CHECK(!file.open(filename) && !file.isOpen());
+		std::remove(filename.c_str());
+	}
+
+	// Nested transactions: tiles and bitplanes change at once, quads only at the outermost endEdit()
+	void testMapEditTransactions(const std::string& directory)
+	{
+		const TileId solid = getTiles().getTileFromIndex('a');
+		const TileId empty = getTiles().getDefaultTile();
+		Map map(getTiles());
+		CHECK(loadEmptyMap(map, directory));
+
+		map.setTile(1, 1, solid);
+		const TileChunk* chunk = MapTests::findChunk(map, 0, 0);
+		CHECK(chunk && chunk->quadCells.size() == 1);
+		const std::vector<sf::Vertex> vertices = chunk->vertices;
+
+		map.beginEdit();
+		map.beginEdit();
+		map.setTile(2, 1, solid);
+		map.setTile(1, 1, empty);
+		map.endEdit();
+
+		CHECK(map.getTile(2, 1) == solid && map.getTile(1, 1) == empty);
+		CHECK(map.touchingTile(Box{ 2.f * TILE_SIZEf, TILE_SIZEf, TILE_SIZEf, TILE_SIZEf }, Tile::Property::Solid));
+		CHECK(chunk->quadCells.size() == 1 && chunk->quadCells[0] == CHUNK_SIZEi + 1);	// not rebuilt yet
+		CHECK(chunk->vertices.size() == vertices.size() && chunk->vertices[0].position == vertices[0].position);
+
+		map.endEdit();
+		CHECK(chunk->quadCells.size() == 1 && chunk->quadCells[0] == CHUNK_SIZEi + 2);
+		CHECK(MapTests::areQuadsConsistent(map, *chunk, { 0, 0 }));
+
+		map.endEdit();	// unbalanced: ignored
+		CHECK(MapTests::areQuadsConsistent(map, *chunk, { 0, 0 }));
+	}
+
+	// The fill replaces the 4-connected area of the start tile, the outside stops one tile around the map
+	void testMapFloodFill(const std::string& directory)
+	{
+		const TileId solid = getTiles().getTileFromIndex('a');
+		const TileId ladder = getTiles().getTileFromIndex('l');
+		const TileId empty = getTiles().getDefaultTile();
+		Map map(getTiles());
+		CHECK(loadEmptyMap(map, directory));
+
+		// a solid ring around (1, 1) - (4, 4), across the chunk edge at x = 0
+		for (int i = -1; i <= 4; ++i)
+		{
+			map.setTile(i, -1, solid);
+			map.setTile(i, 4, solid);
+			map.setTile(-1, i, solid);
+			map.setTile(4, i, solid);
+		}
+
+		map.floodFill({ 1, 1 }, ladder);
+		CHECK(map.getTile(0, 0) == ladder && map.getTile(3, 3) == ladder && map.getTile(-1, 0) == solid);
+		CHECK(map.getTile(-2, 0) == empty && map.getTile(5, 5) == empty);
+		CHECK(map.getBounds() == sf::IntRect(-1, -1, 6, 6));
+
+		map.floodFill({ -2, -2 }, ladder);
+		CHECK(map.getTile(-2, -2) == ladder && map.getTile(5, 5) == ladder && map.getTile(-2, 5) == ladder);
+		CHECK(map.getTile(-3, 0) == empty && map.getTile(6, 0) == empty);
+		CHECK(map.getBounds() == sf::IntRect(-2, -2, 8, 8));
+
+		// Already that tile, or outside the margin: nothing to do
+		map.floodFill({ 0, 0 }, ladder);
+		map.floodFill({ 100, 100 }, solid);
+		CHECK(map.getTile(100, 100) == empty && map.getBounds() == sf::IntRect(-2, -2, 8, 8));
+	}
+
+	// Walking along a streamed level evicts the chunks left behind, but never an edited one
+	void testMapStreamingEviction(const std::string& directory)
+	{
+		// 40 chunks in a row, a floor at the bottom of each
+		const int length = 40;
+		std::vector<LevelChunk> chunks;
+		for (int cx = 0; cx < length; ++cx)
+		{
+			LevelChunk chunk{ { cx, 0 }, std::vector<std::uint8_t>(CHUNK_SIZEi * CHUNK_SIZEi, 0) };
+			std::fill(chunk.cells.end() - CHUNK_SIZEi, chunk.cells.end(), (std::uint8_t)1);
+			chunks.push_back(std::move(chunk));
+		}
+		const std::string filename = directory + "/streaming.bin";
+		CHECK(LevelFile::write(filename, CHUNK_SIZEi, ".a", chunks, {}));
+
+		auto levelFile = std::make_unique<LevelFile>();
+		CHECK(levelFile->open(filename));
+
+		const TileId solid = getTiles().getTileFromIndex('a');
+		Map map(getTiles());
+		CHECK(map.stream(std::move(levelFile)));
+		map.setStreamingRadius(1);
+		const std::size_t capacity = (2 * 1 + 1) * (2 * 1 + 1) * 2;
+
+		// Edited in the first chunk: pinned
+		const float chunkWidth = (float)CHUNK_SIZEi * TILE_SIZEf;
+		map.streamInAround({ 0.f, 0.f });
+		map.setTile(2, 3, solid);
+
+		std::size_t maxCount = 0;
+		for (int cx = 0; cx < length; ++cx)
+		{
+			const sf::Vector2f center(((float)cx + 0.5f) * chunkWidth, 0.f);
+			map.streamInAround(center);
+			map.updateStreaming(center);
+			maxCount = std::max(maxCount, map.getChunkCount());
+		}
+
+		CHECK(maxCount <= capacity + 1);	// + the edited chunk
+		CHECK(MapTests::findChunk(map, 0, 0) && MapTests::findChunk(map, 0, 0)->at(2, 3) == solid);
+		CHECK(!MapTests::findChunk(map, length / 2 * CHUNK_SIZEi, 0));	// far behind: evicted
+		CHECK(map.getTile((length - 1) * CHUNK_SIZEi, CHUNK_SIZEi - 1) == solid);
+
+		map.clear();	// the streaming thread reads the file
+		std::remove(filename.c_str());
+	}
+
+	void testInputScript(const std::string& directory)
+	{
+		const std::string filename = directory + "/script.txt";
+		{
+			std::ofstream script(filename);
+			script << "# comment\n"
+				   << "0 -\n"
+				   << "\n"
+				   << "10 right jump	# trailing comment\n"
+				   << "20 left up down\n"
+				   << "30 -\n";
+		}
+
+		InputScript script;
+		CHECK(script.load(filename));
+		CHECK(script.getChanges().size() == 4);
+		CHECK(script.getLastTick() == 30);
+		CHECK(script.at(9) == PlayerInput());
+		CHECK(script.at(10).right && script.at(10).jump && !script.at(10).left);
+		CHECK(script.at(19) == script.at(10));
+		CHECK(script.at(25).left && script.at(25).up && script.at(25).down && !script.at(25).right);
+		CHECK(script.at(1000) == PlayerInput());
+
+		// Ticks must increase
+		{
+			std::ofstream unordered(filename);
+			unordered << "10 right\n5 left\n";
+		}
+		CHECK(!script.load(filename));
+		std::remove(filename.c_str());
+	}
+
+	// A shipped text level saved as level.bin, as the editor does, and loaded back
+	void testLevelBinRoundTrip(const std::string& directory)
+	{
+		Simulation simulation;
+		CHECK(simulation.loadLevel(LEVELS_PATH + "parkour", true));
+		const Map& map = simulation.getMap();
+
+		std::string palette;
+		for (const Tile& tile : simulation.getTilesManager().getTiles())
+			palette += tile.indexInFile;
+
+		const std::string filename = directory + "/level.bin";
+		CHECK(LevelFile::write(filename, CHUNK_SIZEi, palette, map.exportChunks(), {}));
+
+		LevelFile file;
+		CHECK(file.open(filename));
+		Map loaded(simulation.getTilesManager());
+		CHECK(loaded.load(file));
+
+		const sf::IntRect bounds = map.getBounds();
+		CHECK(loaded.getBounds() == bounds);
+		int mismatches = 0;
+		for (int y = bounds.top - 1; y <= bounds.top + bounds.height; ++y)
+		{
+			for (int x = bounds.left - 1; x <= bounds.left + bounds.width; ++x)
+				mismatches += map.getTile(x, y) != loaded.getTile(x, y) ? 1 : 0;
+		}
+		CHECK(mismatches == 0);
+		file.close();
+		std::remove(filename.c_str());
+	}
+}
+
+/** Unit checks of the simulation code, run by CTest from the source directory (shipped levels):
+ *
+ *    WandererTests <scratch directory>
+ *
+ *  Prints every failed check, the exit code is 1 if any failed **/
+int main(int argc, char** argv)
+{
+	const std::string directory = argc >= 2 ? argv[1] : ".";
+
+	testMapChunkBoundaries();
+	testMapQuadUpdates();
+	testMapTouchedProperties(directory);
+	testMapSweeps(directory);
+	testMapEditTransactions(directory);
+	testMapFloodFill(directory);
+	testSpatialHashPairs();
+	testWorldHandles();
+	testLevelFileRoundTrip(directory);
+	testMapStreamingEviction(directory);
+	testInputScript(directory);
+	testLevelBinRoundTrip(directory);
+
+	if (failures > 0)
+	{
+		std::cerr << failures << " check(s) failed" << std::endl;
+		return 1;
+	}
+	std::cout << "all checks passed" << std::endl;
+	return 0;
+}